@@ -0,0 +1,279 @@
+// Churn benchmark for ContactGraph.
+//
+// Usage: contact_graph_bench [--contacts N] [--out results.json] [--min-ms N]
+//
+// Builds a graph of N contacts (100k by default) over N / 3 circles with a skewed degree distribution, so
+// some neighborhoods spill past the inline storage, then measures begin/end touch churn, neighbor sweeps and
+// circle removal. The previous unordered_map-of-unordered_set graph runs the same operation stream as the
+// baseline and as a correctness reference: the bench exits with status 1 if the two disagree.
+
+#include "circles/contact_graph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+struct Options {
+    std::size_t contacts = 100000;
+    std::string out_path;
+    double min_seconds = 0.2;
+};
+
+// The graph as it was before dense slots, kept as the baseline.
+class LegacyContactGraph {
+public:
+    void add_contact(CircleId a, CircleId b) {
+        if (a == b) return;
+        adjacency[a].insert(b);
+        adjacency[b].insert(a);
+    }
+
+    void remove_contact(CircleId a, CircleId b) {
+        if (a == b) return;
+        auto itA = adjacency.find(a);
+        if (itA != adjacency.end()) {
+            itA->second.erase(b);
+            if (itA->second.empty()) adjacency.erase(itA);
+        }
+        auto itB = adjacency.find(b);
+        if (itB != adjacency.end()) {
+            itB->second.erase(a);
+            if (itB->second.empty()) adjacency.erase(itB);
+        }
+    }
+
+    void remove_circle(CircleId id) {
+        auto it = adjacency.find(id);
+        if (it == adjacency.end()) return;
+        for (CircleId neighbor : it->second) {
+            auto nb = adjacency.find(neighbor);
+            if (nb != adjacency.end()) {
+                nb->second.erase(id);
+                if (nb->second.empty()) adjacency.erase(nb);
+            }
+        }
+        adjacency.erase(it);
+    }
+
+    template <typename Fn>
+    void for_each_neighbor(CircleId id, const Fn& fn) const {
+        auto it = adjacency.find(id);
+        if (it == adjacency.end()) return;
+        for (CircleId neighbor : it->second) {
+            fn(neighbor);
+        }
+    }
+
+private:
+    std::unordered_map<CircleId, std::unordered_set<CircleId>> adjacency;
+};
+
+struct Workload {
+    std::uint32_t circles = 0;
+    std::vector<std::pair<CircleId, CircleId>> initial;
+    // Churn: each step ends one live contact and begins a fresh one, like sensor events between steps.
+    std::vector<std::pair<CircleId, CircleId>> churn_end;
+    std::vector<std::pair<CircleId, CircleId>> churn_begin;
+    std::vector<CircleId> removals;
+};
+
+struct TimingResult {
+    std::string op;
+    std::string graph;
+    std::size_t iterations = 0;
+    double ns_per_op = 0.0;
+};
+
+// Degree skew: a tenth of the circles are big creatures touching many pellets.
+CircleId random_circle(std::uint32_t circles, std::mt19937& rng) {
+    std::uniform_int_distribution<std::uint32_t> any(1, circles);
+    std::uniform_int_distribution<std::uint32_t> hub(1, std::max(1u, circles / 10));
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    return CircleId{unit(rng) < 0.3f ? hub(rng) : any(rng)};
+}
+
+Workload make_workload(std::size_t contacts, std::mt19937& rng) {
+    Workload w;
+    w.circles = static_cast<std::uint32_t>(std::max<std::size_t>(contacts / 3, 16));
+    std::unordered_set<std::uint64_t> live_keys;
+    std::vector<std::pair<CircleId, CircleId>> live;
+    const auto key = [](CircleId a, CircleId b) {
+        if (b.value < a.value) std::swap(a, b);
+        return (static_cast<std::uint64_t>(a.value) << 32) | b.value;
+    };
+    const auto fresh_pair = [&]() {
+        while (true) {
+            CircleId a = random_circle(w.circles, rng);
+            CircleId b = random_circle(w.circles, rng);
+            if (a != b && live_keys.insert(key(a, b)).second) return std::make_pair(a, b);
+        }
+    };
+    while (live.size() < contacts) {
+        live.push_back(fresh_pair());
+    }
+    w.initial = live;
+
+    const std::size_t churn_steps = contacts * 2;
+    for (std::size_t i = 0; i < churn_steps; ++i) {
+        std::uniform_int_distribution<std::size_t> pick(0, live.size() - 1);
+        const std::size_t index = pick(rng);
+        w.churn_end.push_back(live[index]);
+        live_keys.erase(key(live[index].first, live[index].second));
+        live[index] = fresh_pair();
+        w.churn_begin.push_back(live[index]);
+    }
+
+    for (std::uint32_t i = 0; i < w.circles / 20; ++i) {
+        w.removals.push_back(random_circle(w.circles, rng));
+    }
+    return w;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs the whole workload on a fresh graph until min_seconds elapsed, timing each phase separately.
+template <typename Graph>
+void run(const char* name, const Workload& w, const Options& options, std::vector<TimingResult>& timings) {
+    TimingResult build{"build", name};
+    TimingResult churn{"churn_end_begin", name};
+    TimingResult sweep{"neighbor_sweep", name};
+    TimingResult remove{"remove_circle", name};
+    double build_s = 0.0, churn_s = 0.0, sweep_s = 0.0, remove_s = 0.0;
+    volatile std::uint32_t sink = 0;
+    const auto total_start = std::chrono::steady_clock::now();
+    do {
+        Graph graph;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [a, b] : w.initial) graph.add_contact(a, b);
+        build_s += seconds_since(start);
+        build.iterations += w.initial.size();
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < w.churn_end.size(); ++i) {
+            graph.remove_contact(w.churn_end[i].first, w.churn_end[i].second);
+            graph.add_contact(w.churn_begin[i].first, w.churn_begin[i].second);
+        }
+        churn_s += seconds_since(start);
+        churn.iterations += w.churn_end.size();
+
+        start = std::chrono::steady_clock::now();
+        std::uint32_t sum = 0;
+        for (std::uint32_t c = 1; c <= w.circles; ++c) {
+            graph.for_each_neighbor(CircleId{c}, [&](CircleId n) { sum += n.value; });
+        }
+        sink = sink + sum;
+        sweep_s += seconds_since(start);
+        sweep.iterations += w.circles;
+
+        start = std::chrono::steady_clock::now();
+        for (CircleId id : w.removals) graph.remove_circle(id);
+        remove_s += seconds_since(start);
+        remove.iterations += w.removals.size();
+    } while (seconds_since(total_start) < options.min_seconds);
+
+    build.ns_per_op = build_s * 1e9 / static_cast<double>(build.iterations);
+    churn.ns_per_op = churn_s * 1e9 / static_cast<double>(churn.iterations);
+    sweep.ns_per_op = sweep_s * 1e9 / static_cast<double>(sweep.iterations);
+    remove.ns_per_op = remove_s * 1e9 / static_cast<double>(remove.iterations);
+    timings.push_back(build);
+    timings.push_back(churn);
+    timings.push_back(sweep);
+    timings.push_back(remove);
+}
+
+template <typename Graph>
+std::vector<std::vector<std::uint32_t>> final_adjacency(const Workload& w) {
+    Graph graph;
+    for (const auto& [a, b] : w.initial) graph.add_contact(a, b);
+    for (std::size_t i = 0; i < w.churn_end.size(); ++i) {
+        graph.remove_contact(w.churn_end[i].first, w.churn_end[i].second);
+        graph.add_contact(w.churn_begin[i].first, w.churn_begin[i].second);
+    }
+    for (CircleId id : w.removals) graph.remove_circle(id);
+    std::vector<std::vector<std::uint32_t>> adjacency(w.circles + 1);
+    for (std::uint32_t c = 1; c <= w.circles; ++c) {
+        graph.for_each_neighbor(CircleId{c}, [&](CircleId n) { adjacency[c].push_back(n.value); });
+        std::sort(adjacency[c].begin(), adjacency[c].end());
+    }
+    return adjacency;
+}
+
+void write_json(std::ostream& out, std::size_t contacts, bool consistent, const std::vector<TimingResult>& timings) {
+    out << "{\n";
+    out << "  \"contacts\": " << contacts << ",\n";
+    out << "  \"consistent_with_legacy\": " << (consistent ? "true" : "false") << ",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < timings.size(); ++i) {
+        const TimingResult& t = timings[i];
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "    {\"op\": \"%s\", \"graph\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.2f}%s\n",
+                      t.op.c_str(),
+                      t.graph.c_str(),
+                      t.iterations,
+                      t.ns_per_op,
+                      i + 1 < timings.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--contacts" && i + 1 < argc) {
+            options.contacts = static_cast<std::size_t>(std::max(16L, std::atol(argv[++i])));
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.out_path = argv[++i];
+        } else if (arg == "--min-ms" && i + 1 < argc) {
+            options.min_seconds = std::max(1.0, std::atof(argv[++i])) / 1000.0;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--contacts N] [--out results.json] [--min-ms N]\n";
+        return 2;
+    }
+
+    std::mt19937 rng(1234);
+    const Workload workload = make_workload(options.contacts, rng);
+    const bool consistent = final_adjacency<ContactGraph>(workload) == final_adjacency<LegacyContactGraph>(workload);
+    if (!consistent) {
+        std::cerr << "ContactGraph disagrees with the legacy graph after the churn workload\n";
+    }
+
+    std::vector<TimingResult> timings;
+    run<LegacyContactGraph>("legacy_hash_sets", workload, options, timings);
+    run<ContactGraph>("dense_slots", workload, options, timings);
+
+    if (options.out_path.empty()) {
+        write_json(std::cout, options.contacts, consistent, timings);
+    } else {
+        std::ofstream out(options.out_path);
+        if (!out) {
+            std::cerr << "cannot write " << options.out_path << "\n";
+            return 1;
+        }
+        write_json(out, options.contacts, consistent, timings);
+    }
+    return consistent ? 0 : 1;
+}
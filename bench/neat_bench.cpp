@@ -0,0 +1,371 @@
+// Microbenchmarks for neat::Genome.
+//
+// Usage: neat_bench [corpus.txt] [--out results.json] [--min-ms N]
+//
+// The corpus is a genome dump written by the "Export brain corpus" button (see neat/genome_corpus.hpp)
+// or a binary archive from "Save brain archive" (see neat/genome_io.hpp).
+// Without one, a synthetic corpus of creature-shaped genomes is grown by repeated mutation.
+// Results are printed as JSON: one entry per operation and genome size class with ns and heap
+// allocations per operation, so changes to the NEAT module can be compared run against run.
+
+#include <neat/genome.hpp>
+#include <neat/genome_corpus.hpp>
+#include <neat/genome_io.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+struct AllocCounters {
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+};
+
+AllocCounters g_allocs;
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++g_allocs.count;
+    g_allocs.bytes += size;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+// Matches CreatureCircle::brain_input_count_for(8) / BRAIN_OUTPUTS for the default 8 color sensors.
+constexpr int kSyntheticInputs = 8 * 3 + 1 + 4;
+constexpr int kSyntheticOutputs = 10;
+constexpr float kSyntheticWeightExtremum = 1.0f;
+
+struct SizeClass {
+    const char* name;
+    std::size_t min_connections;
+    std::size_t max_connections;
+};
+
+constexpr SizeClass kSizeClasses[] = {
+    {"tiny", 0, 32},
+    {"small", 32, 128},
+    {"medium", 128, 512},
+    {"large", 512, std::numeric_limits<std::size_t>::max()},
+};
+
+struct Measurement {
+    std::size_t iterations = 0;
+    double ns_per_op = 0.0;
+    double allocs_per_op = 0.0;
+    double bytes_per_op = 0.0;
+};
+
+struct Result {
+    std::string op;
+    std::string size_class;
+    std::size_t genomes = 0;
+    double mean_connections = 0.0;
+    Measurement measurement;
+};
+
+struct Options {
+    std::string corpus_path;
+    std::string out_path;
+    double min_seconds = 0.2;
+};
+
+float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+// Runs op(i) until at least min_seconds elapsed; the clock is read once per batch to keep its cost out.
+template <typename Op>
+Measurement measure(Op&& op, double min_seconds) {
+    using clock = std::chrono::steady_clock;
+    constexpr std::size_t kBatch = 16;
+    Measurement m;
+    const AllocCounters before = g_allocs;
+    const auto start = clock::now();
+    double elapsed = 0.0;
+    while (elapsed < min_seconds) {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            op(m.iterations++);
+        }
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    const double iterations = static_cast<double>(m.iterations);
+    m.ns_per_op = elapsed * 1e9 / iterations;
+    m.allocs_per_op = static_cast<double>(g_allocs.count - before.count) / iterations;
+    m.bytes_per_op = static_cast<double>(g_allocs.bytes - before.bytes) / iterations;
+    return m;
+}
+
+std::vector<neat::Genome> build_synthetic_corpus(std::vector<std::vector<int>>* innovIds, int* lastInnovId) {
+    std::vector<neat::Genome> corpus;
+    constexpr int kRoundsPerTier[] = {4, 16, 64, 256, 1024};
+    constexpr int kGenomesPerTier = 8;
+    for (int rounds : kRoundsPerTier) {
+        for (int g = 0; g < kGenomesPerTier; ++g) {
+            neat::Genome genome(kSyntheticInputs, kSyntheticOutputs, innovIds, lastInnovId, kSyntheticWeightExtremum, false);
+            for (int r = 0; r < rounds; ++r) {
+                genome.mutate(innovIds, lastInnovId, 0.8f, 0.1f, 0.2f, 0.9f, 20, 0.25f, 0.02f, 0.2f, 20);
+                // Layers are only refreshed by a rebuild; the game gets one from the brain tick between mutations.
+                genome.rebuildTopology();
+            }
+            corpus.push_back(std::move(genome));
+        }
+    }
+    return corpus;
+}
+
+std::vector<const neat::Genome*> genomes_in_class(const std::vector<neat::Genome>& corpus, const SizeClass& size_class) {
+    std::vector<const neat::Genome*> out;
+    for (const auto& genome : corpus) {
+        const std::size_t size = genome.connections.size();
+        if (size >= size_class.min_connections && size < size_class.max_connections) {
+            out.push_back(&genome);
+        }
+    }
+    return out;
+}
+
+double mean_connections(const std::vector<const neat::Genome*>& genomes) {
+    if (genomes.empty()) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (const auto* genome : genomes) {
+        total += static_cast<double>(genome->connections.size());
+    }
+    return total / static_cast<double>(genomes.size());
+}
+
+void bench_construction(const std::vector<neat::Genome>& corpus, const Options& options, std::vector<Result>& results) {
+    const int nbInput = corpus.empty() ? kSyntheticInputs : corpus.front().nbInput;
+    const int nbOutput = corpus.empty() ? kSyntheticOutputs : corpus.front().nbOutput;
+    std::vector<std::vector<int>> innovIds;
+    int lastInnovId = 0;
+    for (bool connect : {true, false}) {
+        Result result;
+        result.op = connect ? "construct_connected" : "construct_empty";
+        result.size_class = "all";
+        result.measurement = measure([&](std::size_t) {
+            neat::Genome genome(nbInput, nbOutput, &innovIds, &lastInnovId, kSyntheticWeightExtremum, connect);
+            (void)genome;
+        }, options.min_seconds);
+        results.push_back(result);
+    }
+}
+
+void bench_size_class(const std::vector<neat::Genome>& corpus,
+                      const SizeClass& size_class,
+                      std::vector<std::vector<int>>* innovIds,
+                      int* lastInnovId,
+                      const Options& options,
+                      std::vector<Result>& results) {
+    const auto genomes = genomes_in_class(corpus, size_class);
+    if (genomes.empty()) {
+        return;
+    }
+    auto make_result = [&](const char* op, const Measurement& m) {
+        Result result;
+        result.op = op;
+        result.size_class = size_class.name;
+        result.genomes = genomes.size();
+        result.mean_connections = mean_connections(genomes);
+        result.measurement = m;
+        results.push_back(result);
+    };
+
+    make_result("copy", measure([&](std::size_t i) {
+        neat::Genome copy = *genomes[i % genomes.size()];
+        (void)copy;
+    }, options.min_seconds));
+
+    make_result("crossover", measure([&](std::size_t i) {
+        neat::Genome child = neat::Genome::crossover(*genomes[i % genomes.size()], *genomes[(i + 1) % genomes.size()]);
+        (void)child;
+    }, options.min_seconds));
+
+    make_result("archive_encode", measure([&](std::size_t i) {
+        const std::vector<std::byte> bytes = neat::encodeGenomeArchive({genomes[i % genomes.size()]});
+        (void)bytes;
+    }, options.min_seconds));
+
+    const std::vector<std::byte> archive_bytes = neat::encodeGenomeArchive(genomes);
+    make_result("archive_open", measure([&](std::size_t) {
+        const auto view = neat::GenomeArchiveView::open(archive_bytes.data(), archive_bytes.size());
+        (void)view;
+    }, options.min_seconds));
+    const auto archive = neat::GenomeArchiveView::open(archive_bytes.data(), archive_bytes.size());
+    make_result("archive_decode", measure([&](std::size_t i) {
+        neat::Genome decoded = (*archive)[i % archive->size()].toGenome();
+        (void)decoded;
+    }, options.min_seconds));
+
+    std::vector<neat::Genome> working;
+    working.reserve(genomes.size());
+    for (const auto* genome : genomes) {
+        working.push_back(*genome);
+    }
+
+    make_result("rebuildTopology", measure([&](std::size_t i) {
+        working[i % working.size()].rebuildTopology();
+    }, options.min_seconds));
+
+    std::vector<float> inputs;
+    make_result("runNetwork", measure([&](std::size_t i) {
+        neat::Genome& genome = working[i % working.size()];
+        inputs.assign(static_cast<std::size_t>(genome.nbInput), static_cast<float>(i % 7) * 0.1f);
+        genome.loadInputs(inputs.data());
+        genome.runNetwork(sigmoid);
+    }, options.min_seconds));
+
+    // Division-time mutation with the game's default rates, followed by the rebuild the next brain tick would do.
+    // Genomes drift but stay within their class for short runs.
+    make_result("mutate_and_rebuild", measure([&](std::size_t i) {
+        neat::Genome& genome = working[i % working.size()];
+        genome.mutate(innovIds, lastInnovId, 0.05f, 0.0f, 0.2f, 0.1f, 20, 0.25f, 0.1f, 0.005f, 20);
+        genome.rebuildTopology();
+    }, options.min_seconds));
+}
+
+void bench_innovation_growth(const Options& options, std::vector<Result>& results) {
+    constexpr int kNodeCounts[] = {64, 256, 1024};
+    for (int node_count : kNodeCounts) {
+        std::vector<std::vector<int>> innovIds;
+        int lastInnovId = 0;
+        std::ostringstream size_name;
+        size_name << node_count << "_nodes";
+
+        // Every call lands on a fresh (in, out) pair until the table saturates, so rows keep growing.
+        Result insert;
+        insert.op = "getInnovId_insert";
+        insert.size_class = size_name.str();
+        insert.measurement = measure([&](std::size_t i) {
+            const int pair = static_cast<int>(i % static_cast<std::size_t>(node_count * node_count));
+            neat::Genome::getInnovId(&innovIds, &lastInnovId, pair / node_count, pair % node_count);
+        }, options.min_seconds);
+        results.push_back(insert);
+
+        // Lookups stay within the pairs inserted above so they never grow the table.
+        const std::size_t inserted = std::min(insert.measurement.iterations, static_cast<std::size_t>(node_count * node_count));
+        Result lookup;
+        lookup.op = "getInnovId_lookup";
+        lookup.size_class = size_name.str();
+        lookup.measurement = measure([&](std::size_t i) {
+            const int pair = static_cast<int>((i * 7919u) % inserted);
+            neat::Genome::getInnovId(&innovIds, &lastInnovId, pair / node_count, pair % node_count);
+        }, options.min_seconds);
+        results.push_back(lookup);
+    }
+}
+
+void write_json(std::ostream& out, const Options& options, std::size_t corpus_size, const std::vector<Result>& results) {
+    out << "{\n";
+    out << "  \"corpus\": \"" << (options.corpus_path.empty() ? "synthetic" : options.corpus_path) << "\",\n";
+    out << "  \"genome_count\": " << corpus_size << ",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "    {\"op\": \"%s\", \"size_class\": \"%s\", \"genomes\": %zu, \"mean_connections\": %.1f, "
+                      "\"iterations\": %zu, \"ns_per_op\": %.2f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}%s\n",
+                      r.op.c_str(),
+                      r.size_class.c_str(),
+                      r.genomes,
+                      r.mean_connections,
+                      r.measurement.iterations,
+                      r.measurement.ns_per_op,
+                      r.measurement.allocs_per_op,
+                      r.measurement.bytes_per_op,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            options.out_path = argv[++i];
+        } else if (arg == "--min-ms" && i + 1 < argc) {
+            options.min_seconds = std::max(1.0, std::atof(argv[++i])) / 1000.0;
+        } else if (!arg.empty() && arg[0] != '-' && options.corpus_path.empty()) {
+            options.corpus_path = arg;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [corpus.txt] [--out results.json] [--min-ms N]\n";
+        return 2;
+    }
+
+    std::srand(1234);
+    std::vector<std::vector<int>> innovIds;
+    int lastInnovId = 0;
+    std::vector<neat::Genome> corpus;
+    if (!options.corpus_path.empty()) {
+        corpus = neat::readGenomeArchive(options.corpus_path, &innovIds, &lastInnovId);
+        std::string corpus_error;
+        if (corpus.empty()) {
+            corpus = neat::loadGenomeCorpus(options.corpus_path, &corpus_error);
+        }
+        if (corpus.empty()) {
+            std::cerr << "no genomes loaded from " << options.corpus_path << "\n";
+            if (!corpus_error.empty()) {
+                std::cerr << corpus_error << "\n";
+            }
+            return 1;
+        }
+        neat::seedInnovations(corpus, &innovIds, &lastInnovId);
+    } else {
+        corpus = build_synthetic_corpus(&innovIds, &lastInnovId);
+    }
+
+    std::vector<Result> results;
+    bench_construction(corpus, options, results);
+    for (const auto& size_class : kSizeClasses) {
+        bench_size_class(corpus, size_class, &innovIds, &lastInnovId, options, results);
+    }
+    bench_innovation_growth(options, results);
+
+    if (options.out_path.empty()) {
+        write_json(std::cout, options, corpus.size(), results);
+    } else {
+        std::ofstream out(options.out_path);
+        if (!out) {
+            std::cerr << "cannot write " << options.out_path << "\n";
+            return 1;
+        }
+        write_json(out, options, corpus.size(), results);
+    }
+    return 0;
+}
@@ -0,0 +1,426 @@
+// Accuracy check and microbenchmark for the creature color sensor kernel.
+//
+// Usage: sensor_bench [--out results.json] [--min-ms N]
+//
+// First compares the closed-form circle/wedge overlap against the previous triangle-clipping implementation
+// on random touching configurations (the only ones the sensors see), and against a brute-force polar
+// integration for arbitrary configurations, and checks the vectorized all-sectors kernel against the per-sector
+// one and measures the lookup-table sensing mode against the exact kernel. Also measures the straight-wall table
+// used for the dish boundary against the curved wall. Exits with status 1 if any error exceeds its tolerance
+// (the tables' worst cases are documented rather than gated, only their means are checked). Then times the
+// kernels over every sector of a ring for 4 to 32 sensors and prints JSON.
+
+#include "creatures/sensor_geometry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr float PI = 3.14159265f;
+// Errors are relative to the neighbor's full area, the scale the sensor normalizes against.
+constexpr double kReferenceTolerance = 1e-4;
+constexpr double kExactTolerance = 1e-4;
+constexpr double kTableMeanTolerance = 1e-3;
+constexpr double kWallMeanTolerance = 1e-3;
+
+struct Options {
+    std::string out_path;
+    double min_seconds = 0.2;
+};
+
+struct Case {
+    b2Vec2 center;
+    float radius;
+};
+
+// A sensing creature of radius self_radius within self_radius of the wall; the dish center is in its frame.
+struct WallCase {
+    b2Vec2 dish_center;
+    float dish_radius;
+    float self_radius;
+    float gap;
+};
+
+struct Ring {
+    int sensors = 0;
+    float width = 0.0f;
+    std::vector<float> angles;     // sensors + 1 boundary angles
+    std::vector<b2Vec2> directions; // matching unit vectors
+};
+
+struct AccuracyResult {
+    int sensors = 0;
+    double max_error_vs_reference = 0.0;
+    double max_error_vs_exact = 0.0;
+    double max_error_ring_vs_closed_form = 0.0;
+    double max_error_table = 0.0;
+    double mean_error_table = 0.0;
+    double max_error_wall = 0.0;
+    double mean_error_wall = 0.0;
+    std::size_t reference_skipped = 0;
+};
+
+struct TimingResult {
+    std::string op;
+    int sensors = 0;
+    std::size_t iterations = 0;
+    double ns_per_circle = 0.0;
+};
+
+Ring make_ring(int sensors) {
+    Ring ring;
+    ring.sensors = sensors;
+    ring.width = 2.0f * PI / static_cast<float>(sensors);
+    for (int i = 0; i <= sensors; ++i) {
+        const float angle = -0.5f * ring.width + static_cast<float>(i) * ring.width;
+        ring.angles.push_back(angle);
+        ring.directions.push_back(b2Vec2{std::cos(angle), std::sin(angle)});
+    }
+    return ring;
+}
+
+// Neighbors as the sensors see them: touching a creature of radius self_radius centered at the origin.
+std::vector<Case> make_touching_cases(std::size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Case> cases;
+    cases.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float self_radius = 0.2f + 2.0f * unit(rng);
+        const float radius = 0.05f + 3.0f * unit(rng);
+        const float distance = (self_radius + radius) * unit(rng);
+        const float angle = 2.0f * PI * unit(rng);
+        cases.push_back({b2Vec2{distance * std::cos(angle), distance * std::sin(angle)}, radius});
+    }
+    return cases;
+}
+
+// Creatures in the wall band, up to the self_radius / dish radius ratio of 1/8 the sensors use the table for.
+std::vector<WallCase> make_wall_cases(std::size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<WallCase> cases;
+    cases.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float self_radius = 0.2f + 2.0f * unit(rng);
+        const float min_dish_radius = std::max(30.0f, 8.0f * self_radius);
+        const float dish_radius = min_dish_radius + (70.0f - min_dish_radius) * unit(rng);
+        const float gap = self_radius * (2.0f * unit(rng) - 1.0f);
+        const float angle = 2.0f * PI * unit(rng);
+        const float distance = dish_radius - gap;
+        cases.push_back({b2Vec2{-distance * std::cos(angle), -distance * std::sin(angle)}, dish_radius, self_radius, gap});
+    }
+    return cases;
+}
+
+// Area of the sensing disk outside the dish within a sector, by the same midpoint rule as below.
+double polar_outside_area(const WallCase& c, double start_angle, double width) {
+    constexpr int kSteps = 4096;
+    const double step = width / kSteps;
+    const double self_radius = c.self_radius;
+    double area = 0.0;
+    for (int i = 0; i < kSteps; ++i) {
+        const double theta = start_angle + (i + 0.5) * step;
+        const double ux = std::cos(theta);
+        const double uy = std::sin(theta);
+        const double along = ux * c.dish_center.x + uy * c.dish_center.y;
+        const double across = ux * c.dish_center.y - uy * c.dish_center.x;
+        const double disc = static_cast<double>(c.dish_radius) * c.dish_radius - across * across;
+        double inside = 0.0;
+        if (disc > 0.0) {
+            const double half_chord = std::sqrt(disc);
+            const double near = std::clamp(along - half_chord, 0.0, self_radius);
+            const double far = std::clamp(along + half_chord, 0.0, self_radius);
+            inside = far * far - near * near;
+        }
+        area += 0.5 * (self_radius * self_radius - inside) * step;
+    }
+    return area;
+}
+
+// Midpoint rule over the wedge angle of the radial chord length; converges to the exact overlap.
+double polar_overlap_area(const b2Vec2& center, double radius, double start_angle, double width) {
+    constexpr int kSteps = 16384;
+    const double step = width / kSteps;
+    double area = 0.0;
+    for (int i = 0; i < kSteps; ++i) {
+        const double theta = start_angle + (i + 0.5) * step;
+        const double ux = std::cos(theta);
+        const double uy = std::sin(theta);
+        const double along = ux * center.x + uy * center.y;
+        const double across = ux * center.y - uy * center.x;
+        const double disc = radius * radius - across * across;
+        if (disc <= 0.0) {
+            continue;
+        }
+        const double half_chord = std::sqrt(disc);
+        const double near = std::max(0.0, along - half_chord);
+        const double far = std::max(0.0, along + half_chord);
+        area += 0.5 * (far * far - near * near) * step;
+    }
+    return area;
+}
+
+AccuracyResult check_accuracy(const Ring& ring, std::mt19937& rng) {
+    AccuracyResult result;
+    result.sensors = ring.sensors;
+    for (const Case& c : make_touching_cases(20000, rng)) {
+        const double full = PI * c.radius * c.radius;
+        // The reference's triangle only covers the circle while its far edge clears it; wide sectors around
+        // distant neighbors fall outside that, which was a silent error of the old kernel.
+        const float distance = std::sqrt(c.center.x * c.center.x + c.center.y * c.center.y);
+        if ((distance + c.radius + 1.0f) * std::cos(0.5f * ring.width) < distance + c.radius) {
+            ++result.reference_skipped;
+            continue;
+        }
+        for (int s = 0; s < ring.sensors; ++s) {
+            const float fast = sensor_geometry::circle_wedge_overlap_area(c.center, c.radius, ring.directions[s], ring.directions[s + 1], ring.width);
+            const float reference = sensor_geometry::circle_wedge_overlap_area_reference(c.center, c.radius, ring.angles[s], ring.angles[s + 1]);
+            result.max_error_vs_reference = std::max(result.max_error_vs_reference, std::fabs(fast - reference) / full);
+        }
+    }
+
+    // Arbitrary placements and spans up to a full turn, where the triangle reference is not valid.
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < 300; ++i) {
+        const float radius = 0.05f + 3.0f * unit(rng);
+        const float distance = 4.0f * radius * unit(rng);
+        const float angle = 2.0f * PI * unit(rng);
+        const b2Vec2 center{distance * std::cos(angle), distance * std::sin(angle)};
+        const float start = 2.0f * PI * (unit(rng) - 0.5f);
+        const float width = 2.0f * PI * unit(rng);
+        const double exact = polar_overlap_area(center, radius, start, width);
+        const float fast = sensor_geometry::circle_wedge_overlap_area(center, radius, start, start + width);
+        result.max_error_vs_exact = std::max(result.max_error_vs_exact, std::fabs(fast - exact) / (PI * radius * radius));
+    }
+    return result;
+}
+
+// Runs op(circle) over the whole case list until at least min_seconds elapsed; op covers every sector.
+template <typename CaseT, typename Op>
+TimingResult measure(const char* name, int sensors, const std::vector<CaseT>& cases, Op&& op, double min_seconds) {
+    using clock = std::chrono::steady_clock;
+    TimingResult result;
+    result.op = name;
+    result.sensors = sensors;
+    volatile float sink = 0.0f;
+    const auto start = clock::now();
+    double elapsed = 0.0;
+    while (elapsed < min_seconds) {
+        float sum = 0.0f;
+        for (const CaseT& c : cases) {
+            sum += op(c);
+        }
+        sink = sink + sum;
+        result.iterations += cases.size();
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    result.ns_per_circle = elapsed * 1e9 / static_cast<double>(result.iterations);
+    return result;
+}
+
+template <int N>
+bool bench_sensor_count(const std::vector<Case>& cases,
+                        const Options& options,
+                        std::mt19937& rng,
+                        std::vector<AccuracyResult>& accuracy,
+                        std::vector<TimingResult>& timings) {
+    const Ring ring = make_ring(N);
+    const auto simd_ring = sensor_geometry::make_sector_ring<N>();
+    const sensor_geometry::SectorOverlapTable<N> table(simd_ring);
+    AccuracyResult a = check_accuracy(ring, rng);
+    double table_error_sum = 0.0;
+    const std::vector<Case> accuracy_cases = make_touching_cases(20000, rng);
+    for (const Case& c : accuracy_cases) {
+        typename sensor_geometry::SectorRing<N>::Areas areas;
+        typename sensor_geometry::SectorRing<N>::Areas table_areas;
+        sensor_geometry::circle_sector_ring_overlap(c.center, c.radius, simd_ring, areas);
+        table.overlap(c.center, c.radius, table_areas);
+        const double full = PI * c.radius * c.radius;
+        for (int s = 0; s < N; ++s) {
+            const float scalar = sensor_geometry::circle_wedge_overlap_area(c.center, c.radius, ring.directions[s], ring.directions[s + 1], ring.width);
+            a.max_error_ring_vs_closed_form = std::max(a.max_error_ring_vs_closed_form, std::fabs(areas[s] - scalar) / full);
+            const double table_error = std::fabs(table_areas[s] - areas[s]) / full;
+            a.max_error_table = std::max(a.max_error_table, table_error);
+            table_error_sum += table_error;
+        }
+    }
+    a.mean_error_table = table_error_sum / static_cast<double>(accuracy_cases.size() * N);
+
+    const sensor_geometry::WallOverlapTable<N> wall_table(simd_ring);
+    const std::vector<WallCase> wall_cases = make_wall_cases(4000, rng);
+    double wall_error_sum = 0.0;
+    for (const WallCase& c : wall_cases) {
+        typename sensor_geometry::SectorRing<N>::Areas areas;
+        const float distance = std::sqrt(c.dish_center.x * c.dish_center.x + c.dish_center.y * c.dish_center.y);
+        wall_table.outside(b2Vec2{-c.dish_center.x / distance, -c.dish_center.y / distance}, c.gap, c.self_radius, areas);
+        const double full = PI * c.self_radius * c.self_radius;
+        for (int s = 0; s < N; ++s) {
+            const double wall_error = std::fabs(areas[s] - polar_outside_area(c, ring.angles[s], ring.width)) / full;
+            a.max_error_wall = std::max(a.max_error_wall, wall_error);
+            wall_error_sum += wall_error;
+        }
+    }
+    a.mean_error_wall = wall_error_sum / static_cast<double>(wall_cases.size() * N);
+    accuracy.push_back(a);
+    const bool accurate = a.max_error_vs_reference <= kReferenceTolerance && a.max_error_vs_exact <= kExactTolerance &&
+                          a.max_error_ring_vs_closed_form <= kReferenceTolerance && a.mean_error_table <= kTableMeanTolerance &&
+                          a.mean_error_wall <= kWallMeanTolerance;
+    if (!accurate) {
+        std::cerr << "sensor kernel out of tolerance for " << N << " sensors: " << a.max_error_vs_reference << " vs reference, "
+                  << a.max_error_vs_exact << " vs exact, " << a.max_error_ring_vs_closed_form << " ring vs per-sector, "
+                  << a.mean_error_table << " mean table error, " << a.mean_error_wall << " mean wall error\n";
+    }
+
+    timings.push_back(measure("triangle_reference", N, cases, [&](const Case& c) {
+        float sum = 0.0f;
+        for (int s = 0; s < N; ++s) {
+            sum += sensor_geometry::circle_wedge_overlap_area_reference(c.center, c.radius, ring.angles[s], ring.angles[s + 1]);
+        }
+        return sum;
+    }, options.min_seconds));
+    timings.push_back(measure("closed_form", N, cases, [&](const Case& c) {
+        float sum = 0.0f;
+        for (int s = 0; s < N; ++s) {
+            sum += sensor_geometry::circle_wedge_overlap_area(c.center, c.radius, ring.directions[s], ring.directions[s + 1], ring.width);
+        }
+        return sum;
+    }, options.min_seconds));
+    timings.push_back(measure("ring_all_sectors", N, cases, [&](const Case& c) {
+        typename sensor_geometry::SectorRing<N>::Areas areas;
+        sensor_geometry::circle_sector_ring_overlap(c.center, c.radius, simd_ring, areas);
+        float sum = 0.0f;
+        for (float area : areas) {
+            sum += area;
+        }
+        return sum;
+    }, options.min_seconds));
+    timings.push_back(measure("lookup_table", N, cases, [&](const Case& c) {
+        typename sensor_geometry::SectorRing<N>::Areas areas;
+        table.overlap(c.center, c.radius, areas);
+        float sum = 0.0f;
+        for (float area : areas) {
+            sum += area;
+        }
+        return sum;
+    }, options.min_seconds));
+    // Wall sensing for creatures in the band: the previous per-sector triangle clip against the dish vs the table.
+    const std::vector<WallCase> wall_timing_cases = make_wall_cases(1024, rng);
+    timings.push_back(measure("wall_triangle", N, wall_timing_cases, [&](const WallCase& c) {
+        float sum = 0.0f;
+        for (int s = 0; s < N; ++s) {
+            const float start = ring.angles[s];
+            const float end = ring.angles[s + 1];
+            // Sectors straddling +-pi are clipped in two halves, as the sensors do.
+            if (end > PI) {
+                sum += sensor_geometry::sector_outside_circle_area(c.dish_center, c.dish_radius, c.self_radius, start, PI);
+                sum += sensor_geometry::sector_outside_circle_area(c.dish_center, c.dish_radius, c.self_radius, -PI, end - 2.0f * PI);
+            } else {
+                sum += sensor_geometry::sector_outside_circle_area(c.dish_center, c.dish_radius, c.self_radius, start, end);
+            }
+        }
+        return sum;
+    }, options.min_seconds));
+    timings.push_back(measure("wall_table", N, wall_timing_cases, [&](const WallCase& c) {
+        typename sensor_geometry::SectorRing<N>::Areas areas;
+        const float distance = std::sqrt(c.dish_center.x * c.dish_center.x + c.dish_center.y * c.dish_center.y);
+        wall_table.outside(b2Vec2{-c.dish_center.x / distance, -c.dish_center.y / distance}, c.gap, c.self_radius, areas);
+        float sum = 0.0f;
+        for (float area : areas) {
+            sum += area;
+        }
+        return sum;
+    }, options.min_seconds));
+    return accurate;
+}
+
+void write_json(std::ostream& out, const std::vector<AccuracyResult>& accuracy, const std::vector<TimingResult>& timings) {
+    out << "{\n";
+    out << "  \"accuracy\": [\n";
+    for (std::size_t i = 0; i < accuracy.size(); ++i) {
+        const AccuracyResult& a = accuracy[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "    {\"sensors\": %d, \"max_error_vs_reference\": %.3g, \"reference_skipped\": %zu, \"max_error_vs_exact\": %.3g, "
+                      "\"max_error_ring_vs_closed_form\": %.3g, \"max_error_table\": %.3g, \"mean_error_table\": %.3g, "
+                      "\"max_error_wall\": %.3g, \"mean_error_wall\": %.3g}%s\n",
+                      a.sensors,
+                      a.max_error_vs_reference,
+                      a.reference_skipped,
+                      a.max_error_vs_exact,
+                      a.max_error_ring_vs_closed_form,
+                      a.max_error_table,
+                      a.mean_error_table,
+                      a.max_error_wall,
+                      a.mean_error_wall,
+                      i + 1 < accuracy.size() ? "," : "");
+        out << line;
+    }
+    out << "  ],\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < timings.size(); ++i) {
+        const TimingResult& t = timings[i];
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "    {\"op\": \"%s\", \"sensors\": %d, \"iterations\": %zu, \"ns_per_circle\": %.2f}%s\n",
+                      t.op.c_str(),
+                      t.sensors,
+                      t.iterations,
+                      t.ns_per_circle,
+                      i + 1 < timings.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            options.out_path = argv[++i];
+        } else if (arg == "--min-ms" && i + 1 < argc) {
+            options.min_seconds = std::max(1.0, std::atof(argv[++i])) / 1000.0;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--out results.json] [--min-ms N]\n";
+        return 2;
+    }
+
+    std::mt19937 rng(1234);
+    std::vector<AccuracyResult> accuracy;
+    std::vector<TimingResult> timings;
+    const std::vector<Case> cases = make_touching_cases(1024, rng);
+    bool accurate = true;
+    accurate &= bench_sensor_count<4>(cases, options, rng, accuracy, timings);
+    accurate &= bench_sensor_count<8>(cases, options, rng, accuracy, timings);
+    accurate &= bench_sensor_count<16>(cases, options, rng, accuracy, timings);
+    accurate &= bench_sensor_count<32>(cases, options, rng, accuracy, timings);
+
+    if (options.out_path.empty()) {
+        write_json(std::cout, accuracy, timings);
+    } else {
+        std::ofstream out(options.out_path);
+        if (!out) {
+            std::cerr << "cannot write " << options.out_path << "\n";
+            return 1;
+        }
+        write_json(out, accuracy, timings);
+    }
+    return accurate ? 0 : 1;
+}
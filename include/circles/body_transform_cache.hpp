@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "circles/contact_graph.hpp"
+
+// Body transforms and velocities copied out of Box2D, structure-of-arrays indexed by CircleId slot. Filled
+// from b2World_GetBodyEvents after each step, so only bodies that moved are touched; sleeping bodies keep
+// their last entry. An entry is valid while its stamp equals the owning id, which a recycled slot never
+// matches. Velocity has its own stamp because impulses change it without moving the body.
+class BodyTransformCache {
+public:
+    void store(CircleId id, const b2Vec2& position, const b2Rot& rotation, const b2Vec2& velocity) {
+        const std::uint32_t slot = ensure(id);
+        x[slot] = position.x;
+        y[slot] = position.y;
+        cos_angle[slot] = rotation.c;
+        sin_angle[slot] = rotation.s;
+        vx[slot] = velocity.x;
+        vy[slot] = velocity.y;
+        transform_stamp[slot] = id.value;
+        velocity_stamp[slot] = id.value;
+    }
+
+    void invalidate_velocity(CircleId id) {
+        if (id.slot() < velocity_stamp.size()) velocity_stamp[id.slot()] = 0;
+    }
+
+    bool has_transform(CircleId id) const {
+        return id.value != 0 && id.slot() < transform_stamp.size() && transform_stamp[id.slot()] == id.value;
+    }
+    bool has_velocity(CircleId id) const {
+        return id.value != 0 && id.slot() < velocity_stamp.size() && velocity_stamp[id.slot()] == id.value;
+    }
+
+    b2Vec2 position(CircleId id) const { return b2Vec2{x[id.slot()], y[id.slot()]}; }
+    b2Rot rotation(CircleId id) const { return b2Rot{cos_angle[id.slot()], sin_angle[id.slot()]}; }
+    b2Vec2 linear_velocity(CircleId id) const { return b2Vec2{vx[id.slot()], vy[id.slot()]}; }
+
+private:
+    std::uint32_t ensure(CircleId id) {
+        const std::uint32_t slot = id.slot();
+        if (slot >= x.size()) {
+            const std::size_t size = slot + 1;
+            x.resize(size);
+            y.resize(size);
+            cos_angle.resize(size, 1.0f);
+            sin_angle.resize(size);
+            vx.resize(size);
+            vy.resize(size);
+            transform_stamp.resize(size, 0);
+            velocity_stamp.resize(size, 0);
+        }
+        return slot;
+    }
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> cos_angle;
+    std::vector<float> sin_angle;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<std::uint32_t> transform_stamp;
+    std::vector<std::uint32_t> velocity_stamp;
+};
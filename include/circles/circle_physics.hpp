@@ -1,12 +1,14 @@
 #pragma once
 
 #include <functional>
-#include <unordered_set>
 
 #include <box2d/box2d.h>
-#include <atomic>
 
 #include "circles/contact_graph.hpp"
+class BodyTransformCache;
+class ImpulseCommandBuffer;
+class ShapeResizeQueue;
+class CircleRegistry;
 class DrawableCircle;
 class EatableCircle;
 
@@ -74,14 +76,26 @@ public:
     void apply_right_turn_impulse() const;
 
     float getAngle() const;
+    b2Rot getRotation() const;
 
     void set_density(float new_density, const b2WorldId& worldId);
     void set_impulse_magnitudes(float linear, float angular);
     void set_linear_damping(float damping, const b2WorldId& worldId);
     void set_angular_damping(float damping, const b2WorldId& worldId);
 
-    void add_touching_circle(CirclePhysics* circle_physics);
-    void remove_touching_circle(CirclePhysics* circle_physics);
+    // Touching circles live in the game's ContactGraph (keyed by id) and resolve through the registry; the
+    // for_each_touching* helpers read them from there.
+    void set_contact_store(const ContactGraph& graph, const CircleRegistry& registry);
+    // Once registered, position, angle and velocity are read from the game's BodyTransformCache, which is
+    // refreshed from Box2D's move events after each step. Seeds the entry, since bodies created asleep never
+    // report a move.
+    void set_transform_cache(BodyTransformCache& cache);
+    // Once set, setRadius only updates getRadius() and queues the Box2D shape update for the next flush.
+    void set_resize_queue(ShapeResizeQueue& queue);
+    // Pushes a queued radius to the Box2D shape; false if nothing was pending.
+    bool apply_pending_radius();
+    // Once set, the apply_*_impulse methods record into the buffer and the game applies it in one pass.
+    void set_impulse_buffer(ImpulseCommandBuffer& buffer);
 
     void setRadius(float new_radius, const b2WorldId &worldId);
     void setPosition(const b2Vec2& new_position, const b2WorldId &worldId);
@@ -91,8 +105,12 @@ public:
     void for_each_touching(const std::function<void(const CirclePhysics&)>& fn) const;
     void for_each_touching_drawable(const std::function<void(const DrawableCircle&)>& fn) const;
     void for_each_touching_eatable(const std::function<void(EatableCircle&)>& fn);
+    void wake() const;
+    // Invalid until the CircleRegistry assigns one on registration.
     CircleId get_id() const { return id; }
 private:
+    friend class CircleRegistry;
+
     void set_cached_radius(float r) { radius_cached = r; }
 
     struct BodyState {
@@ -106,8 +124,17 @@ private:
     BodyState captureBodyState() const;
     b2BodyDef buildBodyDef(const BodyState& state) const;
     b2ShapeDef buildCircleShapeDef() const;
+    static b2Filter buildFilter(CircleKind kind);
+    struct SleepPolicy {
+        bool enabled;
+        float threshold; // m/s
+    };
+    static SleepPolicy sleepPolicy(CircleKind kind);
     void createBodyWithState(const b2WorldId& worldId, const BodyState& state);
     void recreateBodyWithState(const b2WorldId& worldId, const BodyState& state);
+    // Writes the body's current Box2D state through to the cache after a direct mutation.
+    void refresh_cached_transform() const;
+    void invalidate_cached_velocity() const;
 
     b2BodyId bodyId;
     float density;
@@ -120,7 +147,13 @@ private:
     float radius_cached = 1.0f;
     CircleKind kind;
     CircleId id;
+    const ContactGraph* contact_graph = nullptr;
+    const CircleRegistry* contact_registry = nullptr;
+    BodyTransformCache* transform_cache = nullptr;
+    ShapeResizeQueue* resize_queue = nullptr;
+    ImpulseCommandBuffer* impulse_buffer = nullptr;
+    bool radius_pending = false;
 protected:
-    std::unordered_set<CirclePhysics*> touching_circles;
-    void set_kind(CircleKind k) { kind = k; }
+    // Also refreshes the shape's collision filter and the body's sleep settings, which depend on the kind.
+    void set_kind(CircleKind k);
 };
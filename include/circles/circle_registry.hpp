@@ -1,56 +1,98 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <vector>
 
 #include "circles/circle_capabilities.hpp"
 #include "circles/contact_graph.hpp"
 #include "circles/circle_physics.hpp"
 
+class DrawableCircle;
+class EatableCircle;
+
+enum CircleCapability : std::uint8_t {
+    CapabilitySenseable = 1 << 0,
+    CapabilityEdible = 1 << 1,
+    CapabilityDrawable = 1 << 2,
+    CapabilityEatable = 1 << 3
+};
+
+// Dense generational slot map from CircleId to the circle and its capabilities. Registering a circle hands it
+// an id naming its slot and the slot's current generation; unregistering bumps the generation, so ids held
+// elsewhere stop resolving instead of reaching whatever reuses the slot. Capability pointers are resolved once
+// at registration, so a lookup is a single indexed load with no casts.
 class CircleRegistry {
 public:
-    void register_circle(CirclePhysics& circle) {
-        entries[circle.get_id()].physics = &circle;
-    }
+    struct Entry {
+        CirclePhysics* physics = nullptr;
+        ISenseable* senseable = nullptr;
+        IEdible* edible = nullptr;
+        const DrawableCircle* drawable = nullptr;
+        EatableCircle* eatable = nullptr;
+        std::uint32_t generation = 1;
+        std::uint8_t capabilities = 0;
 
-    void register_capabilities(CirclePhysics& circle) {
-        CircleId id = circle.get_id();
-        auto& entry = entries[id];
-        entry.physics = &circle;
-        if (auto* senseable = dynamic_cast<ISenseable*>(&circle)) {
-            entry.senseable = senseable;
-        }
-        if (auto* edible = dynamic_cast<IEdible*>(&circle)) {
-            entry.edible = edible;
+        bool has(CircleCapability capability) const { return (capabilities & capability) != 0; }
+    };
+
+    // Assigns the circle its id and records its capabilities. Returns false, leaving the id invalid, once every
+    // one of the 2^22 slots is live or retired.
+    bool register_circle(CirclePhysics& circle);
+
+    void unregister_circle(const CirclePhysics& circle) {
+        const CircleId id = circle.get_id();
+        if (!find(id)) return;
+        Entry& entry = entries[id.slot()];
+        const std::uint32_t next_generation = entry.generation + 1;
+        entry = Entry{};
+        entry.generation = next_generation;
+        // A slot whose generation is exhausted is retired rather than letting old ids alias a new circle.
+        if (entry.generation <= CircleId::kMaxGeneration) {
+            free_slots.push_back(id.slot());
         }
+        --live;
     }
 
-    void unregister_circle(const CirclePhysics& circle) {
-        entries.erase(circle.get_id());
+    const Entry* find(CircleId id) const {
+        const std::uint32_t slot = id.slot();
+        if (slot >= entries.size()) return nullptr;
+        const Entry& entry = entries[slot];
+        return entry.physics && entry.generation == id.generation() ? &entry : nullptr;
     }
 
+    bool contains(CircleId id) const { return find(id) != nullptr; }
+
     const ISenseable* get_senseable(CircleId id) const {
-        auto it = entries.find(id);
-        if (it == entries.end()) return nullptr;
-        return it->second.senseable;
+        const Entry* entry = find(id);
+        return entry ? entry->senseable : nullptr;
     }
 
     IEdible* get_edible(CircleId id) const {
-        auto it = entries.find(id);
-        if (it == entries.end()) return nullptr;
-        return it->second.edible;
+        const Entry* entry = find(id);
+        return entry ? entry->edible : nullptr;
     }
 
     CirclePhysics* get_physics(CircleId id) const {
-        auto it = entries.find(id);
-        if (it == entries.end()) return nullptr;
-        return it->second.physics;
+        const Entry* entry = find(id);
+        return entry ? entry->physics : nullptr;
+    }
+
+    const DrawableCircle* get_drawable(CircleId id) const {
+        const Entry* entry = find(id);
+        return entry ? entry->drawable : nullptr;
+    }
+
+    EatableCircle* get_eatable(CircleId id) const {
+        const Entry* entry = find(id);
+        return entry ? entry->eatable : nullptr;
     }
 
+    std::size_t size() const { return live; }
+    // One past the highest slot ever handed out; per-slot side tables can be sized by it.
+    std::uint32_t slot_capacity() const { return static_cast<std::uint32_t>(entries.size()); }
+
 private:
-    struct Entry {
-        CirclePhysics* physics = nullptr;
-        ISenseable* senseable = nullptr;
-        IEdible* edible = nullptr;
-    };
-    std::unordered_map<CircleId, Entry> entries;
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> free_slots;
+    std::size_t live = 0;
 };
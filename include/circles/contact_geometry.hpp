@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "circles/circle_registry.hpp"
+#include "circles/contact_graph.hpp"
+
+// Area of the lens shared by two circles whose centers are distance apart.
+inline float circle_overlap_area(float r1, float r2, float distance) {
+    constexpr float PI = 3.14159f;
+    if (distance >= r1 + r2) return 0.0f;
+    if (distance <= std::fabs(r1 - r2)) return PI * std::fmin(r1, r2) * std::fmin(r1, r2);
+
+    float r_sq1 = r1 * r1;
+    float r_sq2 = r2 * r2;
+    float d_sq = distance * distance;
+
+    float clamp1 = std::clamp((d_sq + r_sq1 - r_sq2) / (2.0f * distance * r1), -1.0f, 1.0f);
+    float clamp2 = std::clamp((d_sq + r_sq2 - r_sq1) / (2.0f * distance * r2), -1.0f, 1.0f);
+
+    float part1 = r_sq1 * std::acos(clamp1);
+    float part2 = r_sq2 * std::acos(clamp2);
+    float part3 = 0.5f * std::sqrt((r1 + r2 - distance) * (r1 - r2 + distance) * (-r1 + r2 + distance) * (r1 + r2 + distance));
+
+    return part1 + part2 - part3;
+}
+
+// Pair geometry for every contact in the graph, computed once per tick after the physics step and shared by
+// sensing and eating. Each body position is read once; each pair is evaluated once and seen from both sides.
+// Values are a snapshot: growth or eating later in the same tick does not update them.
+class ContactGeometryCache {
+public:
+    // One contact as seen from one of its circles.
+    struct View {
+        CircleId other;
+        b2Vec2 offset;         // other's center minus self's center
+        float distance = 0.0f;
+        float self_radius = 0.0f;
+        float other_radius = 0.0f;
+        float overlap_area = 0.0f;
+        bool contained = false; // the smaller circle lies entirely inside the larger one
+    };
+
+    void rebuild(const ContactGraph& graph, const CircleRegistry& registry) {
+        nodes.clear();
+        pairs.clear();
+        incidences.clear();
+        node_index.assign(registry.slot_capacity(), kNoNode);
+
+        graph.for_each_circle([&](CircleId id) {
+            const auto* physics = registry.get_physics(id);
+            if (!physics) return;
+            node_index[id.slot()] = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back({id, physics->getPosition(), physics->getRadius(), 0, 0});
+        });
+
+        graph.for_each_contact([&](CircleId a, CircleId b) {
+            const std::uint32_t ia = node_of(a);
+            const std::uint32_t ib = node_of(b);
+            if (ia == kNoNode || ib == kNoNode) return;
+            Node& na = nodes[ia];
+            Node& nb = nodes[ib];
+            Pair pair;
+            pair.a = ia;
+            pair.b = ib;
+            pair.delta = b2Vec2{nb.position.x - na.position.x, nb.position.y - na.position.y};
+            pair.distance = std::sqrt(pair.delta.x * pair.delta.x + pair.delta.y * pair.delta.y);
+            pair.overlap_area = circle_overlap_area(na.radius, nb.radius, pair.distance);
+            pair.contained = pair.distance <= std::fabs(na.radius - nb.radius);
+            pairs.push_back(pair);
+            ++na.count;
+            ++nb.count;
+        });
+
+        // Per-circle runs of (pair, side) so a circle's contacts are contiguous.
+        std::uint32_t offset = 0;
+        for (Node& node : nodes) {
+            node.first = offset;
+            offset += node.count;
+            node.count = 0;
+        }
+        incidences.resize(offset);
+        for (std::uint32_t p = 0; p < pairs.size(); ++p) {
+            Node& na = nodes[pairs[p].a];
+            Node& nb = nodes[pairs[p].b];
+            incidences[na.first + na.count++] = {p, false};
+            incidences[nb.first + nb.count++] = {p, true};
+        }
+    }
+
+    template <typename Fn>
+    void for_each_contact(CircleId id, const Fn& fn) const {
+        const std::uint32_t index = node_of(id);
+        if (index == kNoNode) return;
+        const Node& self = nodes[index];
+        for (std::uint32_t i = self.first; i < self.first + self.count; ++i) {
+            const Incidence& incidence = incidences[i];
+            const Pair& pair = pairs[incidence.pair];
+            const Node& other = nodes[incidence.flipped ? pair.a : pair.b];
+            const float sign = incidence.flipped ? -1.0f : 1.0f;
+            View view;
+            view.other = other.id;
+            view.offset = b2Vec2{sign * pair.delta.x, sign * pair.delta.y};
+            view.distance = pair.distance;
+            view.self_radius = self.radius;
+            view.other_radius = other.radius;
+            view.overlap_area = pair.overlap_area;
+            view.contained = pair.contained;
+            fn(view);
+        }
+    }
+
+    std::size_t pair_count() const { return pairs.size(); }
+
+private:
+    static constexpr std::uint32_t kNoNode = ~0u;
+
+    // Indexed by registry slot; the stored node's id settles whether a handle is current.
+    std::uint32_t node_of(CircleId id) const {
+        const std::uint32_t slot = id.slot();
+        if (slot >= node_index.size() || node_index[slot] == kNoNode) return kNoNode;
+        return nodes[node_index[slot]].id == id ? node_index[slot] : kNoNode;
+    }
+
+    struct Node {
+        CircleId id;
+        b2Vec2 position;
+        float radius;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+    struct Pair {
+        std::uint32_t a = 0;
+        std::uint32_t b = 0;
+        b2Vec2 delta{0.0f, 0.0f}; // b's center minus a's center
+        float distance = 0.0f;
+        float overlap_area = 0.0f;
+        bool contained = false;
+    };
+    struct Incidence {
+        std::uint32_t pair;
+        bool flipped; // self is the pair's b side
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> node_index;
+    std::vector<Pair> pairs;
+    std::vector<Incidence> incidences;
+};
@@ -1,11 +1,22 @@
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <vector>
 
+// Handle into the CircleRegistry: the low kSlotBits are the registry slot, the rest its generation. Live
+// circles have generation >= 1, so value 0 never names one.
 struct CircleId {
+    static constexpr uint32_t kSlotBits = 22;
+    static constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    static constexpr uint32_t kMaxGeneration = ~0u >> kSlotBits;
+
     uint32_t value = 0;
+
+    static CircleId make(uint32_t slot, uint32_t generation) { return CircleId{(generation << kSlotBits) | slot}; }
+    uint32_t slot() const { return value & kSlotMask; }
+    uint32_t generation() const { return value >> kSlotBits; }
     bool operator==(const CircleId& other) const { return value == other.value; }
     bool operator!=(const CircleId& other) const { return value != other.value; }
 };
@@ -19,50 +30,201 @@ struct hash<CircleId> {
 };
 } // namespace std
 
+// Undirected touching graph. Each circle owns the node at its registry slot, holding its first kInlineNeighbors
+// neighbors, so finding a circle's neighbors is one indexed load; larger neighborhoods spill into one contiguous block from a pooled overflow array (power-of-two size classes with
+// free lists, so churn does not allocate). Neighbor order is not stable: removal swaps the last neighbor in.
 class ContactGraph {
 public:
+    static constexpr std::uint32_t kInlineNeighbors = 6;
+
     void add_contact(CircleId a, CircleId b) {
         if (a == b) return;
-        adjacency[a].insert(b);
-        adjacency[b].insert(a);
+        const std::uint32_t slot_a = acquire_slot(a);
+        if (find_neighbor(nodes[slot_a], b) != kNotFound) return; // both sides already linked
+        const std::uint32_t slot_b = acquire_slot(b);
+        push_neighbor(slot_a, b);
+        push_neighbor(slot_b, a);
+        ++contacts;
     }
 
     void remove_contact(CircleId a, CircleId b) {
         if (a == b) return;
-        auto itA = adjacency.find(a);
-        if (itA != adjacency.end()) {
-            itA->second.erase(b);
-            if (itA->second.empty()) adjacency.erase(itA);
-        }
-        auto itB = adjacency.find(b);
-        if (itB != adjacency.end()) {
-            itB->second.erase(a);
-            if (itB->second.empty()) adjacency.erase(itB);
+        const std::uint32_t slot_a = find_slot(a);
+        const std::uint32_t slot_b = find_slot(b);
+        if (slot_a == kNotFound || slot_b == kNotFound) return;
+        if (erase_neighbor(slot_a, b)) {
+            erase_neighbor(slot_b, a);
+            --contacts;
         }
     }
 
     void remove_circle(CircleId id) {
-        auto it = adjacency.find(id);
-        if (it == adjacency.end()) return;
-        for (CircleId neighbor : it->second) {
-            auto nb = adjacency.find(neighbor);
-            if (nb != adjacency.end()) {
-                nb->second.erase(id);
-                if (nb->second.empty()) adjacency.erase(nb);
+        const std::uint32_t slot = find_slot(id);
+        if (slot == kNotFound) return;
+        for_each_neighbor_in_slot(slot, [&](CircleId neighbor) {
+            const std::uint32_t other = find_slot(neighbor);
+            if (other != kNotFound) {
+                erase_neighbor(other, id);
             }
-        }
-        adjacency.erase(it);
+        });
+        contacts -= nodes[slot].count;
+        release_overflow(nodes[slot]);
+        nodes[slot] = Node{};
     }
 
     template <typename Fn>
     void for_each_neighbor(CircleId id, const Fn& fn) const {
-        auto it = adjacency.find(id);
-        if (it == adjacency.end()) return;
-        for (CircleId neighbor : it->second) {
-            fn(neighbor);
+        const std::uint32_t slot = find_slot(id);
+        if (slot == kNotFound) return;
+        for_each_neighbor_in_slot(slot, fn);
+    }
+
+    // Circles with at least one contact.
+    template <typename Fn>
+    void for_each_circle(const Fn& fn) const {
+        for (const Node& node : nodes) {
+            if (node.count > 0) {
+                fn(node.id);
+            }
+        }
+    }
+
+    // Visits every contact once, as (lower id, higher id).
+    template <typename Fn>
+    void for_each_contact(const Fn& fn) const {
+        for (std::uint32_t slot = 0; slot < nodes.size(); ++slot) {
+            const CircleId id = nodes[slot].id;
+            for_each_neighbor_in_slot(slot, [&](CircleId neighbor) {
+                if (id.value < neighbor.value) {
+                    fn(id, neighbor);
+                }
+            });
         }
     }
 
+    std::size_t neighbor_count(CircleId id) const {
+        const std::uint32_t slot = find_slot(id);
+        return slot == kNotFound ? 0 : nodes[slot].count;
+    }
+    std::size_t contact_count() const { return contacts; }
+    std::size_t overflow_capacity() const { return pool.size(); }
+
 private:
-    std::unordered_map<CircleId, std::unordered_set<CircleId>> adjacency;
+    static constexpr std::uint32_t kNotFound = ~0u;
+    static constexpr std::uint32_t kFirstBlockSize = 8;
+    static constexpr int kSizeClasses = 24;
+
+    struct Node {
+        CircleId id;
+        std::uint32_t count = 0;
+        std::uint32_t overflow_offset = 0;
+        std::uint32_t overflow_capacity = 0; // 0 or kFirstBlockSize << size class
+        std::array<CircleId, kInlineNeighbors> inline_neighbors{};
+    };
+
+    // The node is only the circle's while the generation matches; an older handle to the slot finds nothing.
+    std::uint32_t find_slot(CircleId id) const {
+        const std::uint32_t slot = id.slot();
+        return slot < nodes.size() && nodes[slot].id == id ? slot : kNotFound;
+    }
+
+    std::uint32_t acquire_slot(CircleId id) {
+        const std::uint32_t slot = id.slot();
+        if (slot >= nodes.size()) {
+            nodes.resize(slot + 1);
+        }
+        if (nodes[slot].id != id) {
+            if (nodes[slot].count > 0) {
+                remove_circle(nodes[slot].id); // previous occupant was never removed; drop its stale contacts
+            }
+            nodes[slot].id = id;
+        }
+        return slot;
+    }
+
+    CircleId& neighbor_at(Node& node, std::uint32_t i) {
+        return i < kInlineNeighbors ? node.inline_neighbors[i] : pool[node.overflow_offset + i - kInlineNeighbors];
+    }
+    const CircleId& neighbor_at(const Node& node, std::uint32_t i) const {
+        return i < kInlineNeighbors ? node.inline_neighbors[i] : pool[node.overflow_offset + i - kInlineNeighbors];
+    }
+
+    template <typename Fn>
+    void for_each_neighbor_in_slot(std::uint32_t slot, const Fn& fn) const {
+        const Node& node = nodes[slot];
+        const std::uint32_t inline_count = node.count < kInlineNeighbors ? node.count : kInlineNeighbors;
+        for (std::uint32_t i = 0; i < inline_count; ++i) {
+            fn(node.inline_neighbors[i]);
+        }
+        for (std::uint32_t i = kInlineNeighbors; i < node.count; ++i) {
+            fn(pool[node.overflow_offset + i - kInlineNeighbors]);
+        }
+    }
+
+    std::uint32_t find_neighbor(const Node& node, CircleId neighbor) const {
+        for (std::uint32_t i = 0; i < node.count; ++i) {
+            if (neighbor_at(node, i) == neighbor) return i;
+        }
+        return kNotFound;
+    }
+
+    void push_neighbor(std::uint32_t slot, CircleId neighbor) {
+        Node& node = nodes[slot];
+        if (node.count >= kInlineNeighbors + node.overflow_capacity) {
+            grow_overflow(node);
+        }
+        neighbor_at(node, node.count++) = neighbor;
+    }
+
+    // Swap-remove; returns false if neighbor was not linked.
+    bool erase_neighbor(std::uint32_t slot, CircleId neighbor) {
+        Node& node = nodes[slot];
+        const std::uint32_t index = find_neighbor(node, neighbor);
+        if (index == kNotFound) return false;
+        neighbor_at(node, index) = neighbor_at(node, node.count - 1);
+        --node.count;
+        // Hand the block back only well below the inline limit so a neighborhood hovering at it does not thrash.
+        if (node.count <= kInlineNeighbors / 2) {
+            release_overflow(node);
+        }
+        return true;
+    }
+
+    static int size_class(std::uint32_t capacity) {
+        int cls = 0;
+        while ((kFirstBlockSize << cls) < capacity) ++cls;
+        return cls;
+    }
+
+    void grow_overflow(Node& node) {
+        const std::uint32_t capacity = node.overflow_capacity == 0 ? kFirstBlockSize : node.overflow_capacity * 2;
+        const int cls = size_class(capacity);
+        std::uint32_t offset;
+        if (!free_blocks[cls].empty()) {
+            offset = free_blocks[cls].back();
+            free_blocks[cls].pop_back();
+        } else {
+            offset = static_cast<std::uint32_t>(pool.size());
+            pool.resize(pool.size() + capacity);
+        }
+        const std::uint32_t used = node.count > kInlineNeighbors ? node.count - kInlineNeighbors : 0;
+        for (std::uint32_t i = 0; i < used; ++i) {
+            pool[offset + i] = pool[node.overflow_offset + i];
+        }
+        release_overflow(node);
+        node.overflow_offset = offset;
+        node.overflow_capacity = capacity;
+    }
+
+    void release_overflow(Node& node) {
+        if (node.overflow_capacity == 0) return;
+        free_blocks[size_class(node.overflow_capacity)].push_back(node.overflow_offset);
+        node.overflow_offset = 0;
+        node.overflow_capacity = 0;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<CircleId> pool;
+    std::array<std::vector<std::uint32_t>, kSizeClasses> free_blocks{};
+    std::size_t contacts = 0;
 };
@@ -17,8 +17,9 @@ public:
                   float angle = 0.0f,
                   bool boost_particle = false);
     void be_eaten();
-    void set_eaten_by(const CreatureCircle* creature) { eaten_by = creature; }
-    const CreatureCircle* get_eaten_by() const { return eaten_by; }
+    // The eater is kept as an id: it may itself be removed before this circle is culled.
+    void set_eaten_by(CircleId creature) { eaten_by = creature; }
+    CircleId get_eaten_by() const { return eaten_by; }
     bool is_eaten() const;
     bool is_toxic() const { return toxic; }
     void set_toxic(bool value) { toxic = value; update_kind_from_flags(); }
@@ -31,12 +32,12 @@ public:
     bool edible_is_division_pellet() const override { return is_division_pellet(); }
     bool edible_is_boost_particle() const override { return is_boost_particle(); }
     float edible_area() const override { return getArea(); }
-    void edible_mark_eaten(CreatureCircle* eater) override { be_eaten(); set_eaten_by(eater); }
+    void edible_mark_eaten(CreatureCircle* eater) override;
 private:
     void update_kind_from_flags();
     bool eaten = false;
     bool toxic = false;
     bool division_pellet = false;
     bool boost_particle = false;
-    const CreatureCircle* eaten_by = nullptr;
+    CircleId eaten_by;
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+// Impulses recorded during the act phase and applied to Box2D in one pass. The impulse vector is computed
+// when the command is recorded, from the cached rotation, so recording touches no Box2D state; a buffer per
+// worker could later be appended into this one before the flush. Commands keep the body id rather than the
+// circle, so those aimed at bodies destroyed before the flush fail b2Body_IsValid and are dropped.
+// Only impulses on registered circles are deferred. The act phase still calls Box2D directly to create the
+// bodies of boost particles and division children, to set their angle and launch impulse before they are
+// registered, and to move the dividing parent with setPosition (its radius change goes through the
+// ShapeResizeQueue).
+class ImpulseCommandBuffer {
+public:
+    void push_linear(b2BodyId body, const b2Vec2& impulse) {
+        commands.push_back({body, Kind::Linear, impulse, b2Vec2{0.0f, 0.0f}, 0.0f});
+    }
+
+    void push_linear_at_point(b2BodyId body, const b2Vec2& impulse, const b2Vec2& world_point) {
+        commands.push_back({body, Kind::LinearAtPoint, impulse, world_point, 0.0f});
+    }
+
+    void push_angular(b2BodyId body, float impulse) {
+        commands.push_back({body, Kind::Angular, b2Vec2{0.0f, 0.0f}, b2Vec2{0.0f, 0.0f}, impulse});
+    }
+
+    void append(const ImpulseCommandBuffer& other) {
+        commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+    }
+
+    // Applies every recorded command in recording order and empties the buffer; returns how many reached
+    // a live body. on_applied(body) then runs once per such command, after all of them have been applied,
+    // so it sees each body's final velocity.
+    template <typename OnApplied>
+    std::size_t flush(const OnApplied& on_applied) {
+        std::size_t applied = 0;
+        for (const Command& command : commands) {
+            if (!b2Body_IsValid(command.body)) {
+                continue;
+            }
+            switch (command.kind) {
+                case Kind::Linear:
+                    b2Body_ApplyLinearImpulseToCenter(command.body, command.linear, true);
+                    break;
+                case Kind::LinearAtPoint:
+                    b2Body_ApplyLinearImpulse(command.body, command.linear, command.point, true);
+                    break;
+                case Kind::Angular:
+                    b2Body_ApplyAngularImpulse(command.body, command.angular, true);
+                    break;
+            }
+            ++applied;
+        }
+        for (const Command& command : commands) {
+            if (b2Body_IsValid(command.body)) {
+                on_applied(command.body);
+            }
+        }
+        commands.clear();
+        return applied;
+    }
+
+    std::size_t flush() {
+        return flush([](b2BodyId) {});
+    }
+
+    std::size_t size() const { return commands.size(); }
+
+private:
+    enum class Kind : unsigned char { Linear, LinearAtPoint, Angular };
+
+    struct Command {
+        b2BodyId body;
+        Kind kind;
+        b2Vec2 linear;
+        b2Vec2 point;
+        float angular;
+    };
+
+    std::vector<Command> commands;
+};
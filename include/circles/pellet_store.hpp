@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "circles/circle_physics.hpp"
+
+// Food, toxic and division pellets kept outside Box2D: no body, no shape, no sensor events. Pellets never
+// move, so they live as structure-of-arrays in a dense uniform grid over the dish and are found by direct
+// overlap queries. Indices are not stable: removal swaps the last pellet into the freed index.
+class PelletStore {
+public:
+    explicit PelletStore(float cell_size = 2.0f);
+
+    // Grid covers [-half_extent, half_extent] on both axes; pellets outside it fall into the border cells.
+    void set_extent(float half_extent);
+
+    std::uint32_t add(const b2Vec2& position, float radius, CircleKind kind);
+    void clear();
+
+    // Removes every pellet for which pred(index) holds, calling on_remove(kind) for each. Each pellet is
+    // tested exactly once, under the index it had when the call began.
+    template <typename Pred, typename OnRemove>
+    std::size_t remove_if(const Pred& pred, const OnRemove& on_remove) {
+        std::size_t removed = 0;
+        for (std::uint32_t i = static_cast<std::uint32_t>(x.size()); i-- > 0;) {
+            if (pred(i)) {
+                on_remove(kind[i]);
+                remove_at(i);
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+    // Pellets overlapping the disc (center, radius).
+    template <typename Fn>
+    void for_each_in_radius(const b2Vec2& center, float radius, const Fn& fn) const {
+        if (x.empty()) {
+            return;
+        }
+        const float reach = radius + max_radius;
+        const int x0 = cell_coord(center.x - reach);
+        const int x1 = cell_coord(center.x + reach);
+        const int y0 = cell_coord(center.y - reach);
+        const int y1 = cell_coord(center.y + reach);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                for (std::uint32_t i : cells[static_cast<std::size_t>(cy) * dim + static_cast<std::size_t>(cx)]) {
+                    const float dx = x[i] - center.x;
+                    const float dy = y[i] - center.y;
+                    const float r = radius + radii[i];
+                    if (dx * dx + dy * dy <= r * r) {
+                        fn(i);
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Fn>
+    void for_each(const Fn& fn) const {
+        for (std::uint32_t i = 0; i < x.size(); ++i) {
+            fn(i);
+        }
+    }
+
+    b2Vec2 position(std::uint32_t i) const { return b2Vec2{x[i], y[i]}; }
+    float radius(std::uint32_t i) const { return radii[i]; }
+    CircleKind kind_of(std::uint32_t i) const { return kind[i]; }
+    const std::array<float, 3>& color(std::uint32_t i) const { return color_for_kind(kind[i]); }
+    bool is_eaten(std::uint32_t i) const { return eaten[i] != 0; }
+    void mark_eaten(std::uint32_t i) { eaten[i] = 1; }
+    std::size_t size() const { return x.size(); }
+
+    // Same colors EatableCircle gives each pellet kind.
+    static const std::array<float, 3>& color_for_kind(CircleKind kind);
+
+private:
+    int cell_coord(float v) const {
+        const int c = static_cast<int>(std::floor((v + half_extent) * inv_cell_size));
+        return std::clamp(c, 0, static_cast<int>(dim) - 1);
+    }
+    std::uint32_t cell_of(float px, float py) const {
+        return static_cast<std::uint32_t>(cell_coord(py)) * dim + static_cast<std::uint32_t>(cell_coord(px));
+    }
+    void link(std::uint32_t i);
+    void unlink(std::uint32_t i);
+    void remove_at(std::uint32_t i);
+
+    float cell_size;
+    float inv_cell_size;
+    float half_extent = 0.0f;
+    float max_radius = 0.0f;
+    std::uint32_t dim = 1;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radii;
+    std::vector<CircleKind> kind;
+    std::vector<std::uint8_t> eaten;
+    std::vector<std::uint32_t> cell;      // grid cell holding each pellet
+    std::vector<std::uint32_t> cell_slot; // its position inside that cell's list
+    std::vector<std::vector<std::uint32_t>> cells{1};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "circles/circle_registry.hpp"
+
+// Circles whose radius changed since the last flush. CirclePhysics::setRadius updates the cached radius at
+// once but leaves the Box2D shape alone and enqueues its id the first time in a tick; flush() then calls
+// b2Shape_SetCircle once per body, so eating several pellets and boosting in one tick costs one mass and
+// broadphase update instead of one per change. Ids of circles removed before the flush no longer resolve.
+class ShapeResizeQueue {
+public:
+    void request(CircleId id, bool already_pending) {
+        ++requests;
+        if (!already_pending) {
+            pending.push_back(id);
+        }
+    }
+
+    // Returns the number of shapes actually updated.
+    std::size_t flush(const CircleRegistry& registry) {
+        std::size_t applied = 0;
+        for (CircleId id : pending) {
+            if (CirclePhysics* circle = registry.get_physics(id)) {
+                applied += circle->apply_pending_radius() ? 1 : 0;
+            }
+        }
+        pending.clear();
+        last_requests = requests;
+        requests = 0;
+        return applied;
+    }
+
+    // setRadius calls folded into the last flush.
+    std::size_t requests_last_flush() const { return last_requests; }
+
+private:
+    std::vector<CircleId> pending;
+    std::size_t requests = 0;
+    std::size_t last_requests = 0;
+};
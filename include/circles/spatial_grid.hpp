@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "circles/circle_physics.hpp"
+
+// Uniform grid over circle centers, hashed so the dish needs no fixed bounds. Rebuilt from scratch after each
+// physics step; circles added in between are appended with insert() and scanned linearly until the next
+// rebuild. Entries are a snapshot: removed circles stay listed until the next rebuild, so callers resolve ids
+// through the CircleRegistry and skip the ones that no longer exist.
+class SpatialGrid {
+public:
+    struct Item {
+        CircleId id;
+        b2Vec2 position{0.0f, 0.0f};
+        float radius = 0.0f;
+        CircleKind kind = CircleKind::Unknown;
+    };
+
+    explicit SpatialGrid(float cell_size = 4.0f);
+
+    void rebuild(std::vector<Item> new_items);
+    void insert(const Item& item);
+    void clear();
+
+    // Circles overlapping the disc (center, radius); radius 0 picks the circles containing center.
+    template <typename Fn>
+    void for_each_in_radius(const b2Vec2& center, float radius, const Fn& fn) const {
+        const b2Vec2 lower{center.x - radius, center.y - radius};
+        const b2Vec2 upper{center.x + radius, center.y + radius};
+        for_each_candidate(lower, upper, [&](const Item& item) {
+            const float dx = item.position.x - center.x;
+            const float dy = item.position.y - center.y;
+            const float reach = radius + item.radius;
+            if (dx * dx + dy * dy <= reach * reach) {
+                fn(item);
+            }
+        });
+    }
+
+    // Circles whose bounding box overlaps the box [lower, upper].
+    template <typename Fn>
+    void for_each_in_aabb(const b2Vec2& lower, const b2Vec2& upper, const Fn& fn) const {
+        for_each_candidate(lower, upper, [&](const Item& item) {
+            if (item.position.x + item.radius >= lower.x && item.position.x - item.radius <= upper.x &&
+                item.position.y + item.radius >= lower.y && item.position.y - item.radius <= upper.y) {
+                fn(item);
+            }
+        });
+    }
+
+    // Up to k items accepted by filter, nearest center first. Searches rings of cells outwards and stops once
+    // the next ring cannot hold anything closer than the current k-th item.
+    template <typename Filter>
+    std::vector<Item> k_nearest(const b2Vec2& center, std::size_t k, const Filter& filter) const {
+        std::vector<std::pair<float, Item>> best;
+        if (k == 0) {
+            return {};
+        }
+        const auto consider = [&](const Item& item) {
+            if (!filter(item)) return;
+            const float dx = item.position.x - center.x;
+            const float dy = item.position.y - center.y;
+            const float d2 = dx * dx + dy * dy;
+            if (best.size() == k && d2 >= best.back().first) return;
+            if (best.size() == k) best.pop_back();
+            auto at = std::upper_bound(best.begin(), best.end(), d2, [](float value, const auto& entry) { return value < entry.first; });
+            best.insert(at, {d2, item});
+        };
+        for (const Item& item : pending) {
+            consider(item);
+        }
+
+        if (!items.empty()) {
+            const int cx = cell_coord(center.x);
+            const int cy = cell_coord(center.y);
+            // Rings past this one lie entirely outside the occupied cells.
+            const int last_ring = std::max({cx - min_cell_x, max_cell_x - cx, cy - min_cell_y, max_cell_y - cy});
+            for (int ring = 0; ring <= last_ring; ++ring) {
+                if (best.size() == k && ring > 0) {
+                    const float ring_distance = static_cast<float>(ring - 1) * cell_size;
+                    if (best.back().first <= ring_distance * ring_distance) {
+                        break;
+                    }
+                }
+                for_each_cell_in_ring(cx, cy, ring, [&](int x, int y) { for_each_in_cell(x, y, consider); });
+            }
+        }
+
+        std::vector<Item> result;
+        result.reserve(best.size());
+        for (const auto& entry : best) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    std::size_t size() const { return items.size() + pending.size(); }
+    float get_cell_size() const { return cell_size; }
+
+private:
+    int cell_coord(float v) const { return static_cast<int>(std::floor(v * inv_cell_size)); }
+
+    std::size_t bucket_of(int x, int y) const {
+        const auto h = static_cast<std::uint32_t>(x) * 73856093u ^ static_cast<std::uint32_t>(y) * 19349663u;
+        return static_cast<std::size_t>(h) & bucket_mask;
+    }
+
+    template <typename Fn>
+    void for_each_in_cell(int x, int y, const Fn& fn) const {
+        const std::size_t bucket = bucket_of(x, y);
+        for (std::uint32_t i = bucket_start[bucket]; i < bucket_start[bucket + 1]; ++i) {
+            // Several cells can share a bucket; only report the requested one.
+            if (cell_x[i] == x && cell_y[i] == y) {
+                fn(items[i]);
+            }
+        }
+    }
+
+    template <typename Fn>
+    void for_each_cell_in_ring(int cx, int cy, int ring, const Fn& fn) const {
+        const int x0 = std::max(cx - ring, min_cell_x);
+        const int x1 = std::min(cx + ring, max_cell_x);
+        const int y0 = std::max(cy - ring + 1, min_cell_y);
+        const int y1 = std::min(cy + ring - 1, max_cell_y);
+        const auto row = [&](int y) {
+            if (y < min_cell_y || y > max_cell_y) return;
+            for (int x = x0; x <= x1; ++x) fn(x, y);
+        };
+        const auto column = [&](int x) {
+            if (x < min_cell_x || x > max_cell_x) return;
+            for (int y = y0; y <= y1; ++y) fn(x, y);
+        };
+        row(cy - ring);
+        if (ring == 0) return;
+        row(cy + ring);
+        column(cx - ring);
+        column(cx + ring);
+    }
+
+    // Every item whose cell could hold a circle reaching into [lower, upper], plus the pending ones.
+    template <typename Fn>
+    void for_each_candidate(const b2Vec2& lower, const b2Vec2& upper, const Fn& fn) const {
+        for (const Item& item : pending) {
+            fn(item);
+        }
+        if (items.empty()) {
+            return;
+        }
+        const int x0 = std::max(cell_coord(lower.x - max_radius), min_cell_x);
+        const int x1 = std::min(cell_coord(upper.x + max_radius), max_cell_x);
+        const int y0 = std::max(cell_coord(lower.y - max_radius), min_cell_y);
+        const int y1 = std::min(cell_coord(upper.y + max_radius), max_cell_y);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                for_each_in_cell(x, y, fn);
+            }
+        }
+    }
+
+    float cell_size;
+    float inv_cell_size;
+    float max_radius = 0.0f;
+    int min_cell_x = 0;
+    int max_cell_x = -1;
+    int min_cell_y = 0;
+    int max_cell_y = -1;
+    std::size_t bucket_mask = 0;
+    // Items sorted by bucket; bucket b holds items [bucket_start[b], bucket_start[b + 1]).
+    std::vector<Item> items;
+    std::vector<int> cell_x;
+    std::vector<int> cell_y;
+    std::vector<std::uint32_t> bucket_start{0, 0};
+    std::vector<Item> pending;
+};
@@ -1,8 +1,20 @@
 #pragma once
 
-// Central place to set the number of creature color sensors.
-// Change kColorSensorCount to adjust and rebuild.
+// Central place for the number of creature color sensors.
+// The count is fixed per dish (Game constructor, `--sensors N` on the command line) and must be one of
+// kSupportedColorSensorCounts; the sensor pipeline has a specialized instantiation for each.
+// kColorSensorCount is the default.
 constexpr int kColorSensorCount = 8;
-constexpr int kMinColorSensorCount = 1;
+constexpr int kSupportedColorSensorCounts[] = {4, 8, 16, 32};
 constexpr int kMaxColorSensorCount = 32;
 
+constexpr bool is_supported_color_sensor_count(int count) {
+    for (int supported : kSupportedColorSensorCounts) {
+        if (supported == count) {
+            return true;
+        }
+    }
+    return false;
+}
+static_assert(is_supported_color_sensor_count(kColorSensorCount), "Default color sensor count must be supported.");
+
@@ -4,6 +4,9 @@
 #include <functional>
 #include "circles/contact_graph.hpp"
 #include "circles/circle_registry.hpp"
+#include "circles/contact_geometry.hpp"
+#include "circles/pellet_store.hpp"
+#include "circles/spatial_grid.hpp"
 #include "config/simulation_config.hpp"
 #include <neat/genome.hpp>
 
@@ -30,13 +33,17 @@ public:
                 float init_add_connection_thresh = 1.0f,
                 const neat::Genome* base_brain = nullptr,
                 std::vector<std::vector<int>>* innov_ids = nullptr,
-                int* last_innov_id = nullptr);
+                int* last_innov_id = nullptr,
+                int color_sensor_count = kColorSensorCount);
 
     void set_minimum_area(float area) { minimum_area = area; }
     float get_minimum_area() const { return minimum_area; }
     int get_generation() const { return generation; }
     void set_generation(int g) { generation = std::max(0, g); }
     const neat::Genome& get_brain() const { return brain; }
+    int get_species_id() const { return brain.speciesId; }
+    void set_species_id(int id) { brain.speciesId = id; }
+    int get_color_sensor_count() const { return sensor_count; }
 
     void process_eating(const b2WorldId &worldId, Game& game, float poison_death_probability_toxic, float poison_death_probability_normal);
     void update_inactivity(float dt, float timeout);
@@ -54,7 +61,23 @@ public:
     float get_creation_time() const { return creation_time; }
     void set_last_division_time(float t) { last_division_time = t; }
     float get_last_division_time() const { return last_division_time; }
-    void set_contact_context(ContactGraph& graph, CircleRegistry& registry, float petri_radius);
+    void set_contact_context(ContactGraph& graph,
+                             CircleRegistry& registry,
+                             const ContactGeometryCache& geometry,
+                             const SpatialGrid& grid,
+                             PelletStore& pellets,
+                             float petri_radius);
+    // How color sensors measure neighbor coverage: exact geometry or the precomputed overlap table.
+    enum class SensorMode {
+        Exact = 0,
+        LookupTable
+    };
+    // With a vision radius, how each sector summarizes the circles it sees: every circle weighted by coverage
+    // and closeness, or only the nearest one.
+    enum class VisionSummary {
+        Weighted = 0,
+        Nearest
+    };
     struct BehaviorContext {
         float boost_area = 0.0f;
         float circle_density = 0.0f;
@@ -77,6 +100,14 @@ public:
         bool left_key_down = false;
         bool right_key_down = false;
         bool space_key_down = false;
+        bool brain_cache_enabled = false;
+        float brain_cache_epsilon = 0.0f;
+        float brain_cost_per_connection = 0.0f;
+        float brain_cost_per_node = 0.0f;
+        SensorMode sensor_mode = SensorMode::Exact;
+        // 0 senses touching circles only (physics contacts); otherwise circles within this distance of the body.
+        float vision_radius = 0.0f;
+        VisionSummary vision_summary = VisionSummary::Weighted;
         std::function<void(std::unique_ptr<EatableCircle>)> spawn_circle;
     };
     void set_behavior_context(const BehaviorContext& ctx) { behavior = ctx; }
@@ -99,9 +130,18 @@ public:
         float disable_connection_thresh = 0.0f;
         float add_node_thresh = 0.0f;
         int max_iterations_find_node = 0;
+        float mating_probability = 0.0f;
         float sim_time = 0.0f;
     };
     void set_division_context(const DivisionContext& ctx) { division = ctx; }
+    bool last_brain_eval_was_cached() const { return last_brain_cycle_cached; }
+    // Estimated floating point operations for one network evaluation:
+    // a multiply-add per enabled connection plus one activation per evaluated node.
+    int brain_flops_per_eval() const { return 2 * brain_enabled_connections + brain_enabled_hidden_nodes + BRAIN_OUTPUTS; }
+    int get_brain_enabled_connections() const { return brain_enabled_connections; }
+    int get_brain_enabled_hidden_nodes() const { return brain_enabled_hidden_nodes; }
+    float get_last_brain_metabolic_cost() const { return last_brain_metabolic_cost; }
+    int get_last_vision_candidates() const { return last_vision_candidates; }
 
 protected:
     bool should_draw_direction_indicator() const override { return true; }
@@ -110,26 +150,45 @@ private:
     struct ContactContext {
         ContactGraph* graph = nullptr;
         CircleRegistry* registry = nullptr;
+        const ContactGeometryCache* geometry = nullptr;
+        const SpatialGrid* grid = nullptr;
+        PelletStore* pellets = nullptr;
         float petri_radius = 0.0f;
     };
 
-    static constexpr int SENSOR_COUNT = kColorSensorCount;
+    // Brain inputs: sensor_count RGB triples, then size, then memory. Storage is sized for the largest
+    // supported sensor count; only brain_input_count() entries are fed to the network.
     static constexpr int MEMORY_SLOTS = 4;
     static constexpr int BRAIN_OUTPUTS = 10;
-    static constexpr int SENSOR_INPUTS = SENSOR_COUNT * 3;
-    static constexpr int SIZE_INPUT_INDEX = SENSOR_INPUTS;
-    static constexpr int MEMORY_INPUT_START = SIZE_INPUT_INDEX + 1;
-    static constexpr int BRAIN_INPUTS = SENSOR_INPUTS + 1 + MEMORY_SLOTS;
+    static constexpr int MAX_BRAIN_INPUTS = kMaxColorSensorCount * 3 + 1 + MEMORY_SLOTS;
+    static int brain_input_count_for(int sensor_count) { return sensor_count * 3 + 1 + MEMORY_SLOTS; }
+    int brain_input_count() const { return brain_input_count_for(sensor_count); }
+
+    // Sensor input construction is instantiated per supported sensor count and picked once per creature.
+    using SensorPipeline = void (CreatureCircle::*)();
+    static SensorPipeline select_sensor_pipeline(int sensor_count);
+    template <int N>
+    void update_sensor_inputs();
 
     void initialize_brain(int mutation_rounds, float add_node_thresh, float add_connection_thresh);
     void run_brain_cycle_from_touching();
+    bool brain_inputs_match_cache() const;
+    void refresh_brain_size();
+    void apply_brain_metabolic_cost(const b2WorldId& worldId);
+    // Every genome change goes through here, so the enabled connection and hidden node counts are kept current
+    // without recounting each brain tick.
+    void invalidate_brain_cache() {
+        brain_cache_valid = false;
+        refresh_brain_size();
+    }
     void update_brain_inputs_from_touching();
-    void apply_sensor_inputs(const std::array<std::array<float, 3>, SENSOR_COUNT>& summed_colors, const std::array<float, SENSOR_COUNT>& weights);
     void write_size_and_memory_inputs();
     void update_color_from_brain();
     bool can_eat_circle(const CirclePhysics& circle) const;
-    bool has_overlap_to_eat(const CirclePhysics& circle) const;
+    bool has_overlap_to_eat(const ContactGeometryCache::View& contact) const;
     void consume_touching_circle(const b2WorldId &worldId, Game& game, EatableCircle& eatable, float touching_area, float poison_death_probability_toxic, float poison_death_probability_normal);
+    void eat_stored_pellets(const b2WorldId &worldId, Game& game, float poison_death_probability_toxic, float poison_death_probability_normal);
+    void digest(const b2WorldId &worldId, Game& game, bool toxic, bool division_pellet, float touching_area, float poison_death_probability_toxic, float poison_death_probability_normal);
     bool has_sufficient_area_for_division(float divided_area) const;
     std::pair<b2Vec2, b2Vec2> calculate_division_positions(const b2Vec2& original_pos, float angle, float new_radius) const;
     std::unique_ptr<CreatureCircle> create_division_child(const b2WorldId& worldId,
@@ -142,10 +201,21 @@ private:
     void apply_post_division_updates(Game& game, CreatureCircle* child, int next_generation);
     void configure_child_after_division(CreatureCircle& child, const b2WorldId& worldId, const Game& game, float angle, const neat::Genome& parent_brain_copy) const;
     void mutate_lineage(CreatureCircle* child);
+    CreatureCircle* pick_mate() const;
 
+    int sensor_count = kColorSensorCount;
+    SensorPipeline sensor_pipeline = nullptr;
     neat::Genome brain;
-    std::array<float, BRAIN_INPUTS> brain_inputs{};
+    std::array<float, MAX_BRAIN_INPUTS> brain_inputs{};
     std::array<float, BRAIN_OUTPUTS> brain_outputs{};
+    // Inputs of the last real network evaluation; brain_outputs stay valid while inputs stay within epsilon.
+    std::array<float, MAX_BRAIN_INPUTS> cached_brain_inputs{};
+    bool brain_cache_valid = false;
+    bool last_brain_cycle_cached = false;
+    int brain_enabled_connections = 0;
+    int brain_enabled_hidden_nodes = 0;
+    float last_brain_metabolic_cost = 0.0f;
+    int last_vision_candidates = 0;
     std::array<float, MEMORY_SLOTS> memory_state{};
     std::vector<std::vector<int>>* neat_innovations = nullptr;
     int* neat_last_innov_id = nullptr;
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <box2d/box2d.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+// Geometry kernels behind the creature color sensors. All positions are in the sensing creature's local
+// frame (origin at its center, +x forward); wedges have their apex at the origin and open counter-clockwise.
+namespace sensor_geometry {
+
+// Area of the circle (center, radius) that lies inside the wedge from start_dir to end_dir (unit vectors).
+// width is the wedge angle and must be in [0, pi]; callers precompute it together with the boundaries.
+// Closed form: no trigonometry beyond one asin per boundary ray, no branches on angle wrap-around.
+float circle_wedge_overlap_area(const b2Vec2& center, float radius, const b2Vec2& start_dir, const b2Vec2& end_dir, float width);
+
+// Angle-based convenience wrapper; accepts any span up to 2*pi.
+float circle_wedge_overlap_area(const b2Vec2& center, float radius, float start_angle, float end_angle);
+
+// Previous implementation (clip a large triangle against the circle), kept as the accuracy reference.
+float circle_wedge_overlap_area_reference(const b2Vec2& center, float radius, float start_angle, float end_angle);
+
+float circle_triangle_intersection_area(const std::array<b2Vec2, 3>& poly, const b2Vec2& center, float radius);
+
+// Boundary rays of N equal sectors, stored as separate cos/sin arrays so the ring kernel below vectorizes.
+// Sector i runs counter-clockwise from boundary i to boundary i + 1; sector 0 is centered on +x and the last
+// boundary repeats the first, so there is no wrap-around to handle.
+template <int N>
+struct SectorRing {
+    static_assert(N >= 1, "A sector ring needs at least one sector.");
+    static constexpr int kSectors = N;
+    using Areas = std::array<float, N>;
+    std::array<float, N + 1> cos_boundary{};
+    std::array<float, N + 1> sin_boundary{};
+    float width = 0.0f;
+};
+
+template <int N>
+SectorRing<N> make_sector_ring() {
+    constexpr float kPi = 3.14159265f;
+    SectorRing<N> ring;
+    ring.width = 2.0f * kPi / static_cast<float>(N);
+    for (int i = 0; i < N; ++i) {
+        const float angle = -0.5f * ring.width + static_cast<float>(i) * ring.width;
+        ring.cos_boundary[i] = std::cos(angle);
+        ring.sin_boundary[i] = std::sin(angle);
+    }
+    ring.cos_boundary[N] = ring.cos_boundary[0];
+    ring.sin_boundary[N] = ring.sin_boundary[0];
+    return ring;
+}
+
+namespace detail {
+// Branch-free asin (Cephes asinf polynomial, ~1e-7 absolute error) so loops calling it can vectorize;
+// std::asin is an opaque libm call.
+inline float asin_approx(float x) {
+    // Both argument reductions are computed and then selected, which keeps the loop free of branches.
+    const float a = std::fabs(x);
+    const bool wide = a > 0.5f;
+    const float z_wide = 0.5f * (1.0f - a); // >= 0 for |x| <= 1
+    const float s_wide = std::sqrt(z_wide);
+    const float z = wide ? z_wide : a * a;
+    const float s = wide ? s_wide : a;
+    float p = 4.2163199048e-2f;
+    p = p * z + 2.4181311049e-2f;
+    p = p * z + 4.5470025998e-2f;
+    p = p * z + 7.4953002686e-2f;
+    p = p * z + 1.6666752422e-1f;
+    p = p * z * s + s;
+    const float folded = 1.57079632679f - 2.0f * p;
+    const float r = wide ? folded : p;
+    return x < 0.0f ? -r : r;
+}
+
+// atan2 with ~2e-4 rad error (minimax polynomial on [0, 1] plus octant folding), well below the lookup table's
+// bearing bin width and several times cheaper than the libm call.
+inline float atan2_approx(float y, float x) {
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float hi = std::max(ax, ay);
+    const float lo = std::min(ax, ay);
+    const float a = hi > 0.0f ? lo / hi : 0.0f;
+    const float a2 = a * a;
+    float r = -0.0464964749f;
+    r = r * a2 + 0.15931422f;
+    r = r * a2 - 0.327622764f;
+    r = (r * a2 + 1.0f) * a;
+    r = ay > ax ? 1.57079632679f - r : r;
+    r = x < 0.0f ? 3.14159265f - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+// Value-returning clamp to [0, full]; std::clamp returns a reference, which keeps GCC from if-converting.
+inline float clamp_area(float area, float full_area) {
+    area = area < 0.0f ? 0.0f : area;
+    return area > full_area ? full_area : area;
+}
+} // namespace detail
+
+// Overlap area of one circle with every sector of the ring, written to area[] (same contract per sector as
+// circle_wedge_overlap_area). Every boundary is evaluated once and shared by its two sectors; the loops have
+// no data-dependent branches, so the compiler turns them into straight SIMD code (GCC needs -O3 plus
+// -fno-trapping-math -fno-math-errno to if-convert the selects; CMake sets those for the sensor sources).
+template <int N>
+void circle_sector_ring_overlap(const b2Vec2& center, float radius, const SectorRing<N>& ring, typename SectorRing<N>::Areas& area) {
+    const float r2 = radius * radius;
+    const float full_area = 3.14159265f * r2;
+    if constexpr (N == 1) {
+        area[0] = radius > 0.0f ? full_area : 0.0f;
+        return;
+    } else {
+        if (radius <= 0.0f) {
+            area.fill(0.0f);
+            return;
+        }
+        const bool origin_inside = center.x * center.x + center.y * center.y <= r2;
+
+        // Per boundary: signed offset of the center from the ray (q), its projection on the ray (d) and the
+        // chord-strip area between offsets 0 and q.
+        std::array<float, N + 1> across{};
+        std::array<float, N + 1> along{};
+        std::array<float, N + 1> strip{};
+        for (int k = 0; k <= N; ++k) {
+            const float q = ring.cos_boundary[k] * center.y - ring.sin_boundary[k] * center.x;
+            const float d = ring.cos_boundary[k] * center.x + ring.sin_boundary[k] * center.y;
+            const float u = q < -radius ? -radius : (q > radius ? radius : q);
+            const float chord2 = std::max(r2 - u * u, 0.0f);
+            across[k] = q;
+            along[k] = d;
+            strip[k] = u * std::sqrt(chord2) + r2 * detail::asin_approx(u / radius); // exact +-1 at the clamp
+        }
+
+        if (origin_inside) {
+            // Polar area: r^2 * width / 2 plus the difference of -(q d + strip) / 2 between the two boundaries.
+            const float base = 0.5f * r2 * ring.width;
+            for (int i = 0; i < N; ++i) {
+                const float start = across[i] * along[i] + strip[i];
+                const float end = across[i + 1] * along[i + 1] + strip[i + 1];
+                area[i] = detail::clamp_area(base + 0.5f * (start - end), full_area);
+            }
+            return;
+        }
+
+        // Area of the circle clockwise of each ray; rays pointing away from the circle see all of it or none.
+        std::array<float, N + 1> swept{};
+        std::array<float, N + 1> behind{};
+        for (int k = 0; k <= N; ++k) {
+            const float facing = 0.5f * full_area - strip[k];
+            behind[k] = across[k] < 0.0f ? full_area : 0.0f;
+            swept[k] = along[k] < 0.0f ? behind[k] : facing;
+        }
+        for (int i = 0; i < N; ++i) {
+            // The swept area restarts at the ray pointing straight away from the circle: add a full turn when
+            // the sector crosses it (center goes from clockwise to counter-clockwise of the boundary).
+            const float lap = std::max(behind[i] - behind[i + 1], 0.0f);
+            area[i] = detail::clamp_area(swept[i + 1] - swept[i] + lap, full_area);
+        }
+    }
+}
+
+namespace detail {
+// Per-sector fractions sampled over a distance key and a bearing. Rotating the source by one sector rotates the
+// fractions by one slot, so bearings are stored for a single sector width and lookups shift the row. Both axes
+// are bilinearly interpolated.
+template <int N>
+class RotatingSectorTable {
+public:
+    static constexpr int kBearingBins = 32; // per sector width
+    using Areas = typename SectorRing<N>::Areas;
+
+    // fill(distance_index, bearing, row) writes the N fractions for a source at that bearing; bearings span
+    // sector 0, from -width / 2 to width / 2.
+    template <typename Fill>
+    RotatingSectorTable(int distance_samples, float width, Fill&& fill) : distance_samples(distance_samples), width(width) {
+        fractions.resize(static_cast<std::size_t>(distance_samples) * (kBearingBins + 1) * N);
+        for (int i = 0; i < distance_samples; ++i) {
+            for (int j = 0; j <= kBearingBins; ++j) {
+                const float bearing = -0.5f * width + width * static_cast<float>(j) / static_cast<float>(kBearingBins);
+                fill(i, bearing, row(i, j));
+            }
+        }
+    }
+
+    // distance is in sample units (clamped to the table); fractions are scaled by scale.
+    void lookup(float distance, float bearing, float scale, Areas& area) const {
+        distance = std::clamp(distance, 0.0f, static_cast<float>(distance_samples - 1));
+        const int i0 = std::min(static_cast<int>(distance), distance_samples - 2);
+        const float ft = distance - static_cast<float>(i0);
+
+        // Bearing measured from the start of sector 0, split into whole sectors (row shift) and the rest.
+        constexpr float kTwoPi = 6.28318531f;
+        bearing += 0.5f * width;
+        bearing = bearing < 0.0f ? bearing + kTwoPi : bearing;
+        const int shift = std::min(static_cast<int>(bearing / width), N - 1);
+        const float bj = (bearing - static_cast<float>(shift) * width) / width * static_cast<float>(kBearingBins);
+        const int j0 = std::clamp(static_cast<int>(bj), 0, kBearingBins - 1);
+        const float fj = std::clamp(bj - static_cast<float>(j0), 0.0f, 1.0f);
+
+        const float w00 = (1.0f - ft) * (1.0f - fj) * scale;
+        const float w01 = (1.0f - ft) * fj * scale;
+        const float w10 = ft * (1.0f - fj) * scale;
+        const float w11 = ft * fj * scale;
+        const float* r00 = row(i0, j0);
+        const float* r01 = row(i0, j0 + 1);
+        const float* r10 = row(i0 + 1, j0);
+        const float* r11 = row(i0 + 1, j0 + 1);
+        // Sector s of the source's frame is sector s + shift of ours; two contiguous runs instead of a modulo.
+        for (int s = 0; s < N - shift; ++s) {
+            area[s + shift] = w00 * r00[s] + w01 * r01[s] + w10 * r10[s] + w11 * r11[s];
+        }
+        for (int s = N - shift; s < N; ++s) {
+            area[s + shift - N] = w00 * r00[s] + w01 * r01[s] + w10 * r10[s] + w11 * r11[s];
+        }
+    }
+
+    std::size_t size_bytes() const { return fractions.size() * sizeof(float); }
+
+private:
+    float* row(int distance_index, int bearing_index) {
+        return &fractions[(static_cast<std::size_t>(distance_index) * (kBearingBins + 1) + bearing_index) * N];
+    }
+    const float* row(int distance_index, int bearing_index) const {
+        return &fractions[(static_cast<std::size_t>(distance_index) * (kBearingBins + 1) + bearing_index) * N];
+    }
+
+    int distance_samples = 0;
+    float width = 0.0f;
+    std::vector<float> fractions;
+};
+} // namespace detail
+
+// Fraction of a neighbor's area in each sector, read from a table instead of evaluated exactly.
+//
+// Overlap with wedges at the origin is scale invariant, so the per-sector fractions depend only on the
+// normalized distance rho = dist / radius and the bearing of the neighbor. rho is stored on a compressed axis
+// t = rho (inside, rho <= 1) or 2 - 1 / rho (outside), so t in [0, 2] covers every distance.
+//
+// Error (fraction of the neighbor's area per sector, measured by sensor_bench over touching neighbors): mean
+// about 1e-4 for 4 to 32 sectors; at most 0.03 while rho < 8. The worst case, 0.05 with 8+ sectors and 0.2
+// with 4, needs a neighbor much smaller than its distance (t near 2) within half a bearing bin of a sector
+// boundary: the exact fraction is nearly a step there and interpolation smears it over one bin.
+// Table size: 65 x 33 x N floats (67 KB for 8 sectors).
+template <int N>
+class SectorOverlapTable {
+public:
+    static constexpr int kDistanceSamples = 65; // t in [0, 2]
+    using Areas = typename SectorRing<N>::Areas;
+
+    explicit SectorOverlapTable(const SectorRing<N>& ring)
+        : table(kDistanceSamples, ring.width, [&ring](int i, float bearing, float* row) {
+              const float t = 2.0f * static_cast<float>(i) / static_cast<float>(kDistanceSamples - 1);
+              // Unit radius; the last sample stands in for rho -> infinity.
+              const float rho = t <= 1.0f ? t : 1.0f / std::max(2.0f - t, 1e-4f);
+              const b2Vec2 center{rho * std::cos(bearing), rho * std::sin(bearing)};
+              Areas areas;
+              circle_sector_ring_overlap(center, 1.0f, ring, areas);
+              for (int s = 0; s < N; ++s) {
+                  row[s] = areas[s] / 3.14159265f;
+              }
+          }) {}
+
+    // Same contract as circle_sector_ring_overlap, within the error documented above.
+    void overlap(const b2Vec2& center, float radius, Areas& area) const {
+        if (radius <= 0.0f) {
+            area.fill(0.0f);
+            return;
+        }
+        const float rho = std::sqrt(center.x * center.x + center.y * center.y) / radius;
+        const float t = rho <= 1.0f ? rho : 2.0f - 1.0f / rho;
+        table.lookup(t * static_cast<float>(kDistanceSamples - 1) * 0.5f,
+                     detail::atan2_approx(center.y, center.x),
+                     3.14159265f * radius * radius,
+                     area);
+    }
+
+    std::size_t size_bytes() const { return table.size_bytes(); }
+
+private:
+    detail::RotatingSectorTable<N> table;
+};
+
+// Area of the sensing disk (radius self_radius, at the origin) that lies outside a circle (the dish), within
+// the sector from start_angle to end_angle (span at most pi). The sector is replaced by a triangle of equal
+// area and clipped against the circle, so this is an approximation; kept as the fallback for sensing disks
+// too large for WallOverlapTable's straight-wall model.
+float sector_outside_circle_area(const b2Vec2& circle_center, float circle_radius, float self_radius, float start_angle, float end_angle);
+
+// Per-sector area of the sensing disk beyond the dish wall, read from a table.
+//
+// Near the wall the dish boundary is treated as a straight line, so the fractions depend only on the
+// normalized gap h = (dish radius - distance from the dish center) / self_radius in [-1, 1] and the bearing of
+// the outward wall normal. Rows are integrated numerically (64 midpoint steps per sector) when the table is
+// built. Callers only consult it inside the band h < 1; beyond h <= -1 every sector reads as fully outside.
+//
+// Error (fraction of the sensing disk's area per sector, measured by sensor_bench against the curved wall):
+// the straight-wall model misses a sliver of width about self_radius^2 / (2 * dish radius), so the error grows
+// with self_radius / dish radius. Up to the 1/8 ratio callers cap it at: mean below 5e-4, at most 0.005.
+// Table size: 33 x 33 x N floats (35 KB for 8 sectors).
+template <int N>
+class WallOverlapTable {
+public:
+    static constexpr int kGapSamples = 33; // h in [-1, 1]
+    static constexpr int kStepsPerSector = 64;
+    using Areas = typename SectorRing<N>::Areas;
+
+    explicit WallOverlapTable(const SectorRing<N>& ring)
+        : table(kGapSamples, ring.width, [&ring](int i, float bearing, float* row) {
+              const float gap = -1.0f + 2.0f * static_cast<float>(i) / static_cast<float>(kGapSamples - 1);
+              const float step = ring.width / static_cast<float>(kStepsPerSector);
+              for (int s = 0; s < N; ++s) {
+                  // Unit disk; points at r along a ray at angle alpha from the normal are outside when
+                  // r cos(alpha) >= gap.
+                  float area = 0.0f;
+                  const float sector_start = -0.5f * ring.width + static_cast<float>(s) * ring.width;
+                  for (int k = 0; k < kStepsPerSector; ++k) {
+                      const float alpha = sector_start + (static_cast<float>(k) + 0.5f) * step - bearing;
+                      const float c = std::cos(alpha);
+                      float outside = 0.0f; // squared radial extent outside, halved below
+                      if (c > 0.0f && gap < c) {
+                          const float near = std::max(gap / c, 0.0f);
+                          outside = 1.0f - near * near;
+                      } else if (gap <= 0.0f) {
+                          const float far = c < gap ? gap / c : 1.0f;
+                          outside = far * far;
+                      }
+                      area += 0.5f * outside * step;
+                  }
+                  row[s] = area / 3.14159265f;
+              }
+          }) {}
+
+    // outward_normal: unit vector from the dish center through the creature, in the creature's local frame.
+    void outside(const b2Vec2& outward_normal, float gap, float self_radius, Areas& area) const {
+        const float h = gap / self_radius;
+        table.lookup((h + 1.0f) * static_cast<float>(kGapSamples - 1) * 0.5f,
+                     detail::atan2_approx(outward_normal.y, outward_normal.x),
+                     3.14159265f * self_radius * self_radius,
+                     area);
+    }
+
+    std::size_t size_bytes() const { return table.size_bytes(); }
+
+private:
+    detail::RotatingSectorTable<N> table;
+};
+
+} // namespace sensor_geometry
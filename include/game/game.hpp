@@ -8,8 +8,15 @@
 #include <SFML/Graphics.hpp>
 #include <box2d/box2d.h>
 #include <neat/genome.hpp>
+#include <neat/speciation.hpp>
 
+#include "circles/body_transform_cache.hpp"
 #include "circles/circle_registry.hpp"
+#include "circles/impulse_command_buffer.hpp"
+#include "circles/contact_geometry.hpp"
+#include "circles/pellet_store.hpp"
+#include "circles/shape_resize_queue.hpp"
+#include "circles/spatial_grid.hpp"
 #include "circles/eatable_circle.hpp"
 #include "game/selection_manager.hpp"
 #include "game/spawn_types.hpp"
@@ -41,8 +48,47 @@ public:
 #endif
         OldestSmallest
     };
+    // How each b2World_Step is sized: the fixed 1/60 s with 4 substeps, substeps chosen from measured motion
+    // at 1/60 s, or both substeps and step size chosen from measured motion.
+    enum class PhysicsQuality {
+        Fixed = 0,
+        AdaptiveSubsteps,
+        AdaptiveStep
+    };
+
+    // Per-tick counters surfaced in the UI profiler panel.
+    struct ProfilerStats {
+        std::size_t brain_evaluations_last_tick = 0;
+        std::size_t brain_cache_hits_last_tick = 0;
+        std::size_t brain_evaluations_total = 0;
+        std::size_t brain_cache_hits_total = 0;
+        // Brain compute dashboard; "executed" skips cache hits, "nominal" assumes every brain runs.
+        std::size_t brain_flops_executed_last_tick = 0;
+        std::size_t brain_flops_nominal_last_tick = 0;
+        std::size_t brain_connections_last_tick = 0;
+        std::size_t brain_hidden_nodes_last_tick = 0;
+        float brain_metabolic_area_last_tick = 0.0f;
+        std::size_t matings_total = 0;
+        std::size_t contact_pairs_last_tick = 0;
+        std::size_t vision_candidates_last_tick = 0;
+        // From b2World_GetProfile / b2World_GetSensorEvents for the last b2World_Step.
+        float physics_step_ms_last_tick = 0.0f;
+        float physics_sensors_ms_last_tick = 0.0f;
+        std::size_t sensor_events_last_tick = 0;
+        std::size_t contact_graph_pairs = 0;
+        std::size_t awake_bodies = 0;
+        std::size_t sleeping_bodies = 0;
+        std::size_t moved_bodies_last_tick = 0; // move events copied into the BodyTransformCache
+        std::size_t shape_resizes_last_tick = 0;   // b2Shape_SetCircle calls from the ShapeResizeQueue flush
+        std::size_t resize_requests_last_tick = 0; // setRadius calls folded into them
+        std::size_t impulse_commands_last_tick = 0; // impulses applied from the ImpulseCommandBuffer
+        int physics_substeps_last_tick = 0;
+        float physics_dt_last_tick = 0.0f;
+        float fastest_speed_over_radius = 0.0f; // radii per second, moved or impulsed bodies, boost particles excluded
+    };
 
-    Game();
+    // The color sensor count is fixed for the lifetime of the dish; unsupported values fall back to the default.
+    explicit Game(int color_sensor_count = kColorSensorCount);
     ~Game();
 
     // Controller access (avoid adding new trivial wrappers).
@@ -67,10 +113,13 @@ public:
     float get_real_time() const { return timing.real_time_accum; }
     float get_actual_sim_speed() const { return timing.actual_sim_speed_inst; }
     float get_last_fps() const { return fps.last; }
+    const ProfilerStats& get_profiler_stats() const { return profiler; }
     ContactGraph& get_contact_graph() { return contact_graph; }
     const ContactGraph& get_contact_graph() const { return contact_graph; }
     CircleRegistry& get_circle_registry() { return circle_registry; }
+    neat::SpeciationService& get_speciation() { return speciation; }
     const CircleRegistry& get_circle_registry() const { return circle_registry; }
+    const SpatialGrid& get_spatial_grid() const { return spatial_grid; }
 
     // Cursor & spawning
     void set_cursor_mode(CursorMode mode) { cursor.mode = mode; }
@@ -83,6 +132,22 @@ public:
     // Brain & creature
     void set_brain_updates_per_sim_second(float hz) { brain.updates_per_second = hz; }
     float get_brain_updates_per_sim_second() const { return brain.updates_per_second; }
+    void set_brain_eval_cache_enabled(bool enabled) { brain.eval_cache_enabled = enabled; }
+    bool get_brain_eval_cache_enabled() const { return brain.eval_cache_enabled; }
+    void set_brain_eval_cache_epsilon(float epsilon) { brain.eval_cache_epsilon = std::max(0.0f, epsilon); }
+    float get_brain_eval_cache_epsilon() const { return brain.eval_cache_epsilon; }
+    void set_brain_cost_per_connection(float area) { brain.cost_per_connection = std::max(0.0f, area); }
+    float get_brain_cost_per_connection() const { return brain.cost_per_connection; }
+    void set_brain_cost_per_node(float area) { brain.cost_per_node = std::max(0.0f, area); }
+    float get_brain_cost_per_node() const { return brain.cost_per_node; }
+    void set_sensor_mode(CreatureCircle::SensorMode mode) { brain.sensor_mode = mode; }
+    CreatureCircle::SensorMode get_sensor_mode() const { return brain.sensor_mode; }
+    void set_vision_radius(float radius) { brain.vision_radius = std::max(0.0f, radius); }
+    float get_vision_radius() const { return brain.vision_radius; }
+    void set_vision_summary(CreatureCircle::VisionSummary summary) { brain.vision_summary = summary; }
+    CreatureCircle::VisionSummary get_vision_summary() const { return brain.vision_summary; }
+    void set_brain_flops_budget(float flops) { brain.flops_budget = std::max(0.0f, flops); }
+    float get_brain_flops_budget() const { return brain.flops_budget; }
     void set_minimum_area(float area) { creature.minimum_area = area; }
     float get_minimum_area() const { return creature.minimum_area; }
     void set_poison_death_probability(float p) { death.poison_death_probability = p; }
@@ -130,6 +195,19 @@ public:
     void set_init_mutation_rounds(int rounds) { mutation.init_mutation_rounds = std::clamp(rounds, 0, 100); }
     int get_init_mutation_rounds() const { return mutation.init_mutation_rounds; }
     void set_mutation_rounds(int rounds) { mutation.mutation_rounds = std::clamp(rounds, 0, 50); }
+    void set_mating_probability(float p) { mutation.mating_probability = std::clamp(p, 0.0f, 1.0f); }
+    float get_mating_probability() const { return mutation.mating_probability; }
+
+    // Speciation
+    // Turning speciation back on resubmits every live creature, since none were tracked while it was off.
+    void set_speciation_enabled(bool enabled);
+    bool get_speciation_enabled() const { return speciation_settings.enabled; }
+    void set_species_compat_threshold(float threshold) {
+        speciation_settings.coefficients.threshold = std::max(0.01f, threshold);
+        speciation.setCoefficients(speciation_settings.coefficients);
+    }
+    float get_species_compat_threshold() const { return speciation_settings.coefficients.threshold; }
+    neat::SpeciationService::Stats get_speciation_stats() const { return speciation.getStats(); }
     int get_mutation_rounds() const { return mutation.mutation_rounds; }
 
     // Movement
@@ -150,6 +228,7 @@ public:
     int get_minimum_creature_count() const { return dish.minimum_creature_count; }
     void set_auto_remove_outside(bool enabled) { dish.auto_remove_outside = enabled; }
     bool get_auto_remove_outside() const { return dish.auto_remove_outside; }
+    int get_color_sensor_count() const { return dish.color_sensor_count; }
     void set_sprinkle_rate_eatable(float r) { pellets.sprinkle_rate_eatable = r; }
     void set_sprinkle_rate_toxic(float r) { pellets.sprinkle_rate_toxic = r; }
     void set_sprinkle_rate_division(float r) { pellets.sprinkle_rate_division = r; }
@@ -168,6 +247,20 @@ public:
     float get_toxic_pellet_density() const { return pellets.toxic_density; }
     void set_division_pellet_density(float d) { pellets.division_density = std::max(0.0f, d); }
     float get_division_pellet_density() const { return pellets.division_density; }
+    // New food, toxic and division pellets go to the PelletStore instead of Box2D. Pellets already placed
+    // stay where they are when this is toggled.
+    void set_lightweight_pellets(bool enabled) { pellets.lightweight = enabled; }
+    bool get_lightweight_pellets() const { return pellets.lightweight; }
+    std::size_t get_stored_pellet_count() const { return pellet_store.size(); }
+
+    // Physics stepping
+    void set_physics_quality(PhysicsQuality quality) { physics.quality = quality; }
+    PhysicsQuality get_physics_quality() const { return physics.quality; }
+    void set_max_physics_substeps(int n) {
+        physics.max_substeps = std::clamp(n, 1, 8);
+        physics.min_substeps = std::min(physics.min_substeps, physics.max_substeps);
+    }
+    int get_max_physics_substeps() const { return physics.max_substeps; }
 
     // Death & reproduction
     void set_creature_cloud_area_percentage(float percentage) { death.creature_cloud_area_percentage = percentage; }
@@ -205,7 +298,11 @@ public:
 private:
     // Internal helpers used by managers
     void population_adjust_pellet_count(const EatableCircle* circle, int delta);
+    void population_adjust_pellet_count(CircleKind kind, int delta);
     void population_on_creature_added(const CreatureCircle& creature_circle);
+    // Queues the creature's current genome for species assignment; call again whenever the genome changes.
+    // A job still pending under the same id is replaced.
+    void population_submit_for_speciation(const CreatureCircle& creature_circle);
     void population_spawn_cloud(const CreatureCircle& creature, std::vector<std::unique_ptr<EatableCircle>>& out);
     void sim_cleanup_population(float timeStep);
     void sim_remove_outside_if_enabled();
@@ -228,6 +325,14 @@ private:
     struct BrainSettings {
         float updates_per_second = 10.0f;
         float time_accumulator = 0.0f;
+        bool eval_cache_enabled = true;
+        float eval_cache_epsilon = 1e-4f;
+        float cost_per_connection = 0.0f;
+        float cost_per_node = 0.0f;
+        float flops_budget = 0.0f;
+        CreatureCircle::SensorMode sensor_mode = CreatureCircle::SensorMode::Exact;
+        float vision_radius = 0.0f;
+        CreatureCircle::VisionSummary vision_summary = CreatureCircle::VisionSummary::Weighted;
     };
     struct CreatureSettings {
         float minimum_area = 1.0f;
@@ -243,6 +348,7 @@ private:
         float radius = 50.0f;
         int minimum_creature_count = 0;
         bool auto_remove_outside = true;
+        int color_sensor_count = kColorSensorCount;
     };
     struct PelletSettings {
         float sprinkle_rate_eatable = 50.0f;
@@ -260,6 +366,20 @@ private:
         std::size_t food_count_cached = 0;
         std::size_t toxic_count_cached = 0;
         std::size_t division_count_cached = 0;
+        bool lightweight = false;
+    };
+    struct PhysicsSettings {
+        PhysicsQuality quality = PhysicsQuality::AdaptiveSubsteps;
+        int min_substeps = 1;
+        int max_substeps = 4;
+        // Furthest any body may move in one substep, as a fraction of its own radius.
+        float max_travel_fraction = 0.25f;
+        // Bounds for the step size under PhysicsQuality::AdaptiveStep.
+        float min_step = 1.0f / 120.0f;
+        float max_step = 1.0f / 30.0f;
+        // Largest speed / radius among the bodies that moved in the last step or received impulses since,
+        // boost particles excluded (1/s).
+        float max_speed_over_radius = 0.0f;
     };
     struct MutationSettings {
         float add_node_thresh = 0.005f;
@@ -280,6 +400,7 @@ private:
         float init_add_connection_thresh = 0.0f;
         int init_mutation_rounds = 0;
         int mutation_rounds = 1;
+        float mating_probability = 0.0f;
     };
     struct MovementSettings {
         float circle_density = 1.0f;
@@ -306,6 +427,10 @@ private:
         int max_generation = 0;
         std::optional<neat::Genome> brain;
     };
+    struct SpeciationSettings {
+        bool enabled = true;
+        neat::CompatibilityCoefficients coefficients;
+    };
     struct InnovationState {
         std::vector<std::vector<int>> innovations;
         int last_innovation_id = 0;
@@ -328,14 +453,14 @@ private:
 
     struct RemovalResult {
         bool should_remove = false;
-        const CreatureCircle* killer = nullptr;
+        CircleId killer;
     };
     struct CullState {
         std::vector<char> remove_mask;
         bool removed_any = false;
         bool removed_creature = false;
         bool selected_was_removed = false;
-        const CreatureCircle* selected_killer = nullptr;
+        CircleId selected_killer;
     };
     struct SpawnRates {
         float sprinkle = 0.0f;
@@ -346,7 +471,9 @@ private:
     std::vector<std::unique_ptr<EatableCircle>> circles;
     SimulationTiming timing;
     FpsStats fps;
+    ProfilerStats profiler;
     BrainSettings brain;
+    PhysicsSettings physics;
     CreatureSettings creature;
     CursorState cursor;
     SelectionMode selection_mode = SelectionMode::Manual;
@@ -358,12 +485,21 @@ private:
     DeathSettings death;
     GenerationStats generation;
     InnovationState innovation;
+    SpeciationSettings speciation_settings;
+    neat::SpeciationService speciation;
     AgeStats age;
     ViewDragState view_drag;
     SelectionManager selection;
     Spawner spawner;
     ContactGraph contact_graph;
+    ContactGeometryCache contact_geometry;
     CircleRegistry circle_registry;
+    BodyTransformCache body_transforms;
+    ShapeResizeQueue shape_resizes;
+    ImpulseCommandBuffer impulses;
+    SpatialGrid spatial_grid;
+    PelletStore pellet_store;
+    mutable std::vector<sf::Vertex> pellet_vertices; // rebuilt by draw() each frame, kept for its capacity
     PossesingSelectedCreature possesing;
     bool show_true_color = false;
     bool paused = false;
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include <SFML/Graphics.hpp>
@@ -73,7 +74,10 @@ public:
     explicit GamePopulationManager(Game& game);
 
     void add_circle(std::unique_ptr<EatableCircle> circle);
+    void add_pellet(const b2Vec2& position, float radius, CircleKind kind);
     std::size_t get_creature_count() const;
+    bool export_brain_corpus(const std::string& path) const;
+    bool export_brain_archive(const std::string& path) const;
     void cull_consumed();
     void erase_indices_descending(std::vector<std::size_t>& indices);
     void remove_outside_petri();
@@ -89,14 +93,14 @@ public:
 private:
     struct RemovalResult {
         bool should_remove = false;
-        const CreatureCircle* killer = nullptr;
+        CircleId killer;
     };
     struct CullState {
         std::vector<char> remove_mask;
         bool removed_any = false;
         bool removed_creature = false;
         bool selected_was_removed = false;
-        const CreatureCircle* selected_killer = nullptr;
+        CircleId selected_killer;
     };
     struct SpawnRates {
         float sprinkle = 0.0f;
@@ -106,7 +110,9 @@ private:
     RemovalResult evaluate_circle_removal(EatableCircle& circle, std::vector<std::unique_ptr<EatableCircle>>& spawned_cloud);
     CullState collect_removal_state(const SelectionManager::Snapshot& selection_snapshot, std::vector<std::unique_ptr<EatableCircle>>& spawned_cloud);
     void compact_circles(const std::vector<char>& remove_mask);
-    bool is_circle_outside_dish(const EatableCircle& circle, float dish_radius) const;
+    bool is_circle_outside_dish(const b2Vec2& position, float radius, float dish_radius) const;
+    void remove_random_stored_pellets(float percentage, CircleKind kind, bool any_kind);
+    void remove_stored_pellets_if_eaten_or_outside(bool remove_outside);
     bool handle_outside_removal(const std::unique_ptr<EatableCircle>& circle, const SelectionManager::Snapshot& snapshot, float dish_radius, bool& selected_removed, bool& removed_creature);
     std::size_t compute_target_removal_count(std::size_t available, float percentage) const;
     std::vector<std::size_t> collect_pellet_indices(bool toxic, bool division_pellet) const;
@@ -137,7 +143,14 @@ public:
     void apply_damping_to_circles();
 
 private:
+    struct PhysicsStep {
+        float dt;
+        int substeps;
+    };
+    PhysicsStep choose_physics_step() const;
     void update_creatures(const b2WorldId& worldId, float dt);
+    void rebuild_spatial_grid();
+    void apply_species_assignments();
     void run_brain_updates(const b2WorldId& worldId, float timeStep);
     void finalize_world_state();
 
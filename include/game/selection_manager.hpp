@@ -1,25 +1,33 @@
 #pragma once
 
 #include <memory>
-#include <optional>
 #include <vector>
 
 #include <SFML/Graphics/View.hpp>
 #include <box2d/box2d.h>
 
+#include "circles/contact_graph.hpp"
+
 class EatableCircle;
 class CreatureCircle;
+class CircleRegistry;
+class SpatialGrid;
 namespace neat { class Genome; }
 
-// Manages which circle is selected and follow-target logic.
+// Manages which circle is selected and follow-target logic. The selection is held as a CircleId and resolved
+// through the registry on use, so it survives compaction of the circle list and simply stops resolving once
+// the circle is removed.
 class SelectionManager {
 public:
     struct Snapshot {
-        const EatableCircle* circle = nullptr;
+        CircleId id;
         b2Vec2 position{0.0f, 0.0f};
     };
 
-    SelectionManager(std::vector<std::unique_ptr<EatableCircle>>& circles, float& sim_time_accum);
+    SelectionManager(std::vector<std::unique_ptr<EatableCircle>>& circles,
+                     float& sim_time_accum,
+                     const SpatialGrid& grid,
+                     const CircleRegistry& registry);
 
     void clear();
     bool select_circle_at_world(const b2Vec2& pos);
@@ -37,14 +45,20 @@ public:
     void set_follow_selected(bool v);
     bool get_follow_selected() const;
     Snapshot capture_snapshot() const;
-    void revalidate_selection(const EatableCircle* previously_selected);
+    void revalidate_selection();
     void set_selection_to_creature(const CreatureCircle* creature);
+    void set_selection_to_creature(CircleId creature);
     const CreatureCircle* find_nearest_creature(const b2Vec2& pos) const;
-    void handle_selection_after_removal(const Snapshot& snapshot, bool was_removed, const CreatureCircle* preferred_fallback, const b2Vec2& fallback_position);
+    void handle_selection_after_removal(const Snapshot& snapshot, bool was_removed, CircleId preferred_fallback, const b2Vec2& fallback_position);
 
 private:
+    const EatableCircle* resolve_selected() const;
+
     std::vector<std::unique_ptr<EatableCircle>>* circles;
     float* sim_time;
-    std::optional<std::size_t> selected_index;
+    // Picking and nearest-creature lookups go through the grid; ids are resolved through the registry.
+    const SpatialGrid* grid;
+    const CircleRegistry* registry;
+    CircleId selected;
     bool follow_selected = false;
 };
@@ -33,6 +33,7 @@ public:
 private:
     bool pellet_cap_reached(int add_type_value) const;
     void sprinkle_with_rate(float rate, int type, float dt);
+    void spawn_pellet(const b2Vec2& pos, SpawnAddType type);
 
     Game& context;
     bool add_dragging = false;
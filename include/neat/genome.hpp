@@ -7,6 +7,14 @@
 
 namespace neat {
 
+// Result of walking two innovation-sorted connection lists side by side.
+struct GeneAlignment {
+    int matching = 0;
+    int disjoint = 0;
+    int excess = 0;
+    float weightDifferenceSum = 0.0f;
+};
+
 class Genome {
 private:
     float weightExtremumInit;
@@ -14,7 +22,6 @@ private:
     std::vector<std::vector<int>> forwardAdj;
     std::vector<int> topoOrder;
 
-    int getInnovId(std::vector<std::vector<int>>* innovIds, int* lastInnovId, int inNodeId, int outNodeId);
     void mutateWeights(float mutateWeightFullChangeThresh, float mutateWeightFactor, float mutateWeightThresh);
     bool addConnection(std::vector<std::vector<int>>* innovIds, int* lastInnovId, int maxIterationsFindConnectionThresh, float reactivateConnectionThresh);
     bool disableConnection();
@@ -23,24 +30,36 @@ private:
     bool addNode(std::vector<std::vector<int>>* innovIds, int* lastInnovId, int maxIterationsFindNodeThresh);
     void updateLayersRec(int nodeId);
     void ensureForwardLayers();
-    void rebuildTopology();
+    void insertConnectionSorted(const Connection& connection);
     static float randomUnitExclusive();
 
 public:
     int nbInput;
     int nbOutput;
-    float fitness;
+    float fitness = 0.0f;
     int speciesId;
 
     std::vector<Node> nodes;
     std::vector<Connection> connections;
 
     Genome(int nbInput, int nbOutput, std::vector<std::vector<int>>* innovIds, int* lastInnovId, float weightExtremumInit = 20.0f, bool connectInputsToOutputs = true);
+    static int getInnovId(std::vector<std::vector<int>>* innovIds, int* lastInnovId, int inNodeId, int outNodeId);
+    float getWeightExtremumInit() const { return weightExtremumInit; }
+    void rebuildTopology();
     void loadInputs(float inputs[]);
     void runNetwork(float activationFn(float input));
     void getOutputs(float outputs[]);
+    int countEnabledConnections() const;
+    int countEnabledHiddenNodes() const;
     void mutate(std::vector<std::vector<int>>* innovIds, int* lastInnovId, float mutateWeightThresh = 0.8f, float mutateWeightFullChangeThresh = 0.1f, float mutateWeightFactor = 0.1f, float addConnectionThresh = 0.05f, int maxIterationsFindConnectionThresh = 20, float reactivateConnectionThresh = 0.25f, float disableConnectionThresh = 0.0f, float addNodeThresh = 0.03f, int maxIterationsFindNodeThresh = 20);
     void drawNetwork();
+
+    // Connections are kept sorted by innovId so two genomes line up with one linear merge-join.
+    void sortConnectionsByInnovation();
+    static GeneAlignment alignGenes(const Genome& a, const Genome& b);
+    // Offspring takes its structure from the fitter parent (a on ties), so no cycles can appear. Matching
+    // genes pick either parent's weight; one the other parent disabled stays disabled with disabledGeneThresh.
+    static Genome crossover(const Genome& a, const Genome& b, float disabledGeneThresh = 0.75f);
 };
 
 } // namespace neat
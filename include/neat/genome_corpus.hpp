@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <neat/genome.hpp>
+
+namespace neat {
+
+// Plain-text genome dump used to capture brains from real runs for offline tooling (benchmarks, analysis).
+// Layout, one record per line:
+//   genome <nbInput> <nbOutput> <weightExtremumInit> <nodeCount> <connectionCount>
+//   n <id> <layer> <enabled>
+//   c <innovId> <inNodeId> <outNodeId> <weight> <enabled>
+bool saveGenomeCorpus(const std::string& path, const std::vector<const Genome*>& genomes);
+// All or nothing: a malformed record, or counts the rest of the file cannot hold, yields an empty result and,
+// when error is given, a message naming the offending genome.
+std::vector<Genome> loadGenomeCorpus(const std::string& path, std::string* error = nullptr);
+
+// Rebuilds an innovation table that covers every connection in the corpus.
+void seedInnovations(const std::vector<Genome>& genomes, std::vector<std::vector<int>>* innovIds, int* lastInnovId);
+
+} // namespace neat
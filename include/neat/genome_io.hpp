@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <neat/genome.hpp>
+
+namespace neat {
+
+// Versioned binary genome archive.
+//
+// All fields are little-endian and every section starts on an 8-byte boundary, so a memory-mapped
+// archive can be read in place through GenomeArchiveView without any parsing:
+//
+//   GenomeFileHeader
+//   InnovationRecord[innovationCount]     (global (in, out) -> innovId table, for seeding later runs)
+//   uint64_t genomeOffsets[genomeCount]   (byte offset of each genome record from the file start)
+//   per genome: GenomeRecordHeader, NodeRecord[nodeCount], ConnectionRecord[connectionCount]
+constexpr std::uint32_t kGenomeArchiveVersion = 1;
+
+struct GenomeFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t genomeCount;
+    std::uint32_t innovationCount;
+    std::uint64_t innovationOffset;
+    std::uint64_t genomeIndexOffset;
+    std::uint64_t fileSize;
+};
+
+struct GenomeRecordHeader {
+    std::int32_t nbInput;
+    std::int32_t nbOutput;
+    float weightExtremumInit;
+    float fitness;
+    std::int32_t speciesId;
+    std::uint32_t nodeCount;
+    std::uint32_t connectionCount;
+    std::uint32_t reserved;
+};
+
+struct NodeRecord {
+    std::int32_t id;
+    std::int32_t layer;
+    std::uint8_t enabled;
+    std::uint8_t padding[3];
+};
+
+struct ConnectionRecord {
+    std::int32_t innovId;
+    std::int32_t inNodeId;
+    std::int32_t outNodeId;
+    float weight;
+    std::uint8_t enabled;
+    std::uint8_t padding[3];
+};
+
+struct InnovationRecord {
+    std::int32_t inNodeId;
+    std::int32_t outNodeId;
+    std::int32_t innovId;
+};
+
+static_assert(sizeof(GenomeFileHeader) == 48);
+static_assert(sizeof(GenomeRecordHeader) == 32);
+static_assert(sizeof(NodeRecord) == 12);
+static_assert(sizeof(ConnectionRecord) == 20);
+static_assert(sizeof(InnovationRecord) == 12);
+
+// Read-only window onto one genome inside an archive buffer.
+class GenomeView {
+public:
+    GenomeView(const GenomeRecordHeader* header, const NodeRecord* nodes, const ConnectionRecord* connections)
+        : header(header), nodeTable(nodes), connectionTable(connections) {}
+
+    const GenomeRecordHeader& info() const { return *header; }
+    const NodeRecord* nodes() const { return nodeTable; }
+    const ConnectionRecord* connections() const { return connectionTable; }
+    std::size_t nodeCount() const { return header->nodeCount; }
+    std::size_t connectionCount() const { return header->connectionCount; }
+
+    Genome toGenome() const;
+
+private:
+    const GenomeRecordHeader* header;
+    const NodeRecord* nodeTable;
+    const ConnectionRecord* connectionTable;
+};
+
+// open() walks every genome record once, checking section bounds, node ids, node layers within
+// [0, nodeCount) and that every enabled connection runs from a lower layer to a higher one, so a view never
+// hands Genome an index out of range or a cycle. After that, views are zero-copy. The buffer must outlive
+// the view.
+class GenomeArchiveView {
+public:
+    static std::optional<GenomeArchiveView> open(const std::byte* data, std::size_t size);
+
+    std::size_t size() const { return header->genomeCount; }
+    GenomeView operator[](std::size_t index) const;
+    const InnovationRecord* innovations() const;
+    std::size_t innovationCount() const { return header->innovationCount; }
+
+    std::vector<Genome> toGenomes() const;
+    void seedInnovations(std::vector<std::vector<int>>* innovIds, int* lastInnovId) const;
+
+private:
+    GenomeArchiveView(const std::byte* data, const GenomeFileHeader* header) : data(data), header(header) {}
+
+    const std::byte* data;
+    const GenomeFileHeader* header;
+};
+
+// Read-only memory mapping of an archive file (falls back to reading into memory where mmap is unavailable).
+class MappedGenomeArchive {
+public:
+    MappedGenomeArchive() = default;
+    ~MappedGenomeArchive();
+    MappedGenomeArchive(const MappedGenomeArchive&) = delete;
+    MappedGenomeArchive& operator=(const MappedGenomeArchive&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const std::optional<GenomeArchiveView>& view() const { return archive; }
+
+private:
+    const std::byte* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    std::vector<std::byte> fallback;
+    std::optional<GenomeArchiveView> archive;
+};
+
+std::vector<std::byte> encodeGenomeArchive(const std::vector<const Genome*>& genomes, const std::vector<std::vector<int>>* innovIds = nullptr);
+bool writeGenomeArchive(const std::string& path, const std::vector<const Genome*>& genomes, const std::vector<std::vector<int>>* innovIds = nullptr);
+// Loads every genome; when innovIds is given, the archived innovation table is merged into it.
+std::vector<Genome> readGenomeArchive(const std::string& path, std::vector<std::vector<int>>* innovIds = nullptr, int* lastInnovId = nullptr);
+
+} // namespace neat
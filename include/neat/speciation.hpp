@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <neat/genome.hpp>
+
+namespace neat {
+
+struct CompatibilityCoefficients {
+    float excess = 1.0f;
+    float disjoint = 1.0f;
+    float weight = 0.4f;
+    float threshold = 3.0f;
+};
+
+// delta = c1 * E / N + c2 * D / N + c3 * mean |dw|, N = larger gene count (1 below 20 genes, as in NEAT).
+float compatibilityDistance(const Genome& a, const Genome& b, const CompatibilityCoefficients& coefficients);
+
+// Incremental species tracking. Genomes are submitted with a caller-chosen token (e.g. a circle id) and
+// compared against one representative per species on a worker thread; results are picked up later with
+// drainAssignments(). Nothing ever compares the whole population pairwise. A token has at most one
+// pending assignment: submitting again before the worker reaches it only swaps the queued genome.
+class SpeciationService {
+public:
+    struct Assignment {
+        std::uint64_t token = 0;
+        int speciesId = -1;
+    };
+    struct SpeciesInfo {
+        int id = -1;
+        int members = 0;
+    };
+    struct Stats {
+        std::vector<SpeciesInfo> species; // alive species, largest first
+        std::size_t pending = 0;
+        std::size_t assigned_total = 0;
+        std::size_t distance_evaluations = 0;
+        std::size_t cache_hits = 0;
+    };
+
+    SpeciationService();
+    ~SpeciationService();
+    SpeciationService(const SpeciationService&) = delete;
+    SpeciationService& operator=(const SpeciationService&) = delete;
+
+    void setCoefficients(const CompatibilityCoefficients& coefficients);
+    CompatibilityCoefficients getCoefficients() const;
+
+    void submit(std::uint64_t token, const Genome& genome);
+    void release(std::uint64_t token);
+    std::vector<Assignment> drainAssignments();
+    Stats getStats() const;
+
+private:
+    struct Job {
+        enum class Kind { Assign, Release } kind = Kind::Assign;
+        std::uint64_t token = 0;
+        std::uint64_t sequence = 0;
+        std::optional<Genome> genome;
+    };
+    struct Species {
+        int id = -1;
+        int members = 0;
+        Genome representative;
+    };
+    // Direct-mapped memo of (genome hash, species) -> distance; clones from division hit it often.
+    struct CacheEntry {
+        std::uint64_t genomeHash = 0;
+        int speciesId = -1;
+        float distance = 0.0f;
+    };
+    static constexpr std::size_t kCacheSize = 256;
+
+    void workerLoop();
+    void processJob(Job& job);
+    int assignSpecies(const Genome& genome);
+    float cachedDistance(const Genome& genome, std::uint64_t genomeHash, const Species& species);
+    void pushJobLocked(Job job);
+    void refreshStatsLocked();
+    static std::uint64_t hashGenome(const Genome& genome);
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs; // sequences are consecutive, so a job sits at sequence - jobs.front().sequence
+    std::unordered_map<std::uint64_t, std::uint64_t> pendingAssign; // token -> sequence of its queued Assign
+    std::uint64_t nextSequence = 0;
+    std::vector<Assignment> ready;
+    Stats stats;
+    CompatibilityCoefficients coefficients;
+    bool coefficientsChanged = false;
+    bool stopping = false;
+
+    // Worker-owned state.
+    CompatibilityCoefficients workerCoefficients;
+    std::vector<Species> species;
+    std::unordered_map<std::uint64_t, int> memberSpecies;
+    std::array<CacheEntry, kCacheSize> cache{};
+    int nextSpeciesId = 0;
+    std::size_t distanceEvaluations = 0;
+    std::size_t cacheHits = 0;
+    std::size_t assignedTotal = 0;
+
+    std::thread worker;
+};
+
+} // namespace neat
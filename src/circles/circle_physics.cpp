@@ -1,4 +1,8 @@
 #include "circles/circle_physics.hpp"
+#include "circles/body_transform_cache.hpp"
+#include "circles/circle_registry.hpp"
+#include "circles/impulse_command_buffer.hpp"
+#include "circles/shape_resize_queue.hpp"
 #include "circles/drawable_circle.hpp"
 #include "circles/eatable_circle.hpp"
 
@@ -16,10 +20,7 @@ CirclePhysics::CirclePhysics(const b2WorldId &worldId, Config config) :
     linearImpulseMagnitude(5.0f),
     angularImpulseMagnitude(5.0f),
     kind(config.kind),
-    id([]{
-        static std::atomic<uint32_t> next_id{1};
-        return CircleId{next_id.fetch_add(1)};
-    }()) {
+    id{} {
     BodyState initialState{};
     initialState.position = config.position;
     initialState.rotation = b2MakeRot(config.angle);
@@ -35,10 +36,6 @@ CirclePhysics::~CirclePhysics() {
     if (b2Body_IsValid(bodyId)) {
         b2DestroyBody(bodyId);
     }
-
-    for (auto* touching_circle : touching_circles) {
-        touching_circle->remove_touching_circle(this);
-    }
 }
 
 CirclePhysics::BodyState CirclePhysics::captureBodyState() const {
@@ -60,20 +57,102 @@ b2BodyDef CirclePhysics::buildBodyDef(const BodyState& state) const {
     bodyDef.angularVelocity = state.angularVelocity;
     bodyDef.linearDamping = linearDamping;
     bodyDef.angularDamping = angularDamping;
+    bodyDef.userData = const_cast<CirclePhysics*>(this);
+    const SleepPolicy sleep = sleepPolicy(kind);
+    bodyDef.enableSleep = sleep.enabled;
+    bodyDef.sleepThreshold = sleep.threshold;
+    // A pellet placed at rest has nothing to solve, so it starts asleep.
+    const bool at_rest = state.linearVelocity.x == 0.0f && state.linearVelocity.y == 0.0f && state.angularVelocity == 0.0f;
+    bodyDef.isAwake = !(sleep.enabled && at_rest);
     return bodyDef;
 }
 
+namespace {
+constexpr uint64_t kCreatureCategory = 0x1;
+constexpr uint64_t kPelletCategory = 0x2;   // food, toxic and division pellets
+constexpr uint64_t kParticleCategory = 0x4; // boost particles
+} // namespace
+
+// Creatures never sleep: they are driven every brain tick and their sensors must stay live. Boost particles
+// are removed as soon as they stop, so sleeping would only cut that short. Pellets settle quickly under
+// damping; a threshold above Box2D's default (0.05 m/s) lets them drop out of the solver sooner.
+CirclePhysics::SleepPolicy CirclePhysics::sleepPolicy(CircleKind kind) {
+    switch (kind) {
+        case CircleKind::Pellet:
+        case CircleKind::ToxicPellet:
+        case CircleKind::DivisionPellet:
+            return {true, 0.1f};
+        case CircleKind::Creature:
+        case CircleKind::BoostParticle:
+            return {false, 0.05f};
+        case CircleKind::Unknown:
+        default:
+            return {true, 0.05f};
+    }
+}
+
+// Only pairs involving a creature are ever read, so everything else masks out everything but creatures and
+// Box2D never tests or reports pellet-pellet overlaps.
+b2Filter CirclePhysics::buildFilter(CircleKind kind) {
+    b2Filter filter = b2DefaultFilter();
+    switch (kind) {
+        case CircleKind::Creature:
+            filter.categoryBits = kCreatureCategory;
+            break;
+        case CircleKind::Pellet:
+        case CircleKind::ToxicPellet:
+        case CircleKind::DivisionPellet:
+            filter.categoryBits = kPelletCategory;
+            filter.maskBits = kCreatureCategory;
+            break;
+        case CircleKind::BoostParticle:
+            filter.categoryBits = kParticleCategory;
+            filter.maskBits = kCreatureCategory;
+            break;
+        case CircleKind::Unknown:
+        default:
+            break;
+    }
+    return filter;
+}
+
 b2ShapeDef CirclePhysics::buildCircleShapeDef() const {
     b2ShapeDef shapeDef = b2DefaultShapeDef();
     shapeDef.density = density;
     shapeDef.userData = const_cast<CirclePhysics*>(this);
     shapeDef.isSensor = isSensor;
     shapeDef.enableSensorEvents = enableSensorEvents;
+    shapeDef.filter = buildFilter(kind);
     return shapeDef;
 }
 
+void CirclePhysics::set_kind(CircleKind k) {
+    if (kind == k) {
+        return;
+    }
+    kind = k;
+    if (b2Body_IsValid(bodyId)) {
+        b2ShapeId shapeId;
+        b2Body_GetShapes(bodyId, &shapeId, 1);
+        b2Shape_SetFilter(shapeId, buildFilter(kind));
+        const SleepPolicy sleep = sleepPolicy(kind);
+        b2Body_SetSleepThreshold(bodyId, sleep.threshold);
+        b2Body_EnableSleep(bodyId, sleep.enabled);
+        if (!sleep.enabled) {
+            b2Body_SetAwake(bodyId, true);
+        }
+    }
+}
+
+void CirclePhysics::wake() const {
+    if (b2Body_IsValid(bodyId) && !b2Body_IsAwake(bodyId)) {
+        b2Body_SetAwake(bodyId, true);
+    }
+}
+
 void CirclePhysics::createBodyWithState(const b2WorldId& worldId, const BodyState& state) {
     set_cached_radius(state.radius);
+    radius_pending = false;
 
     b2BodyDef bodyDef = buildBodyDef(state);
     bodyId = b2CreateBody(worldId, &bodyDef);
@@ -84,6 +163,7 @@ void CirclePhysics::createBodyWithState(const b2WorldId& worldId, const BodyStat
     circle.radius = state.radius;
 
     b2CreateCircleShape(bodyId, &shapeDef, &circle);
+    refresh_cached_transform();
 }
 
 void CirclePhysics::recreateBodyWithState(const b2WorldId& worldId, const BodyState& state) {
@@ -104,19 +184,24 @@ CirclePhysics::CirclePhysics(CirclePhysics&& other_circle_physics) noexcept :
     angularImpulseMagnitude(other_circle_physics.angularImpulseMagnitude),
     radius_cached(other_circle_physics.radius_cached),
     kind(other_circle_physics.kind),
-    touching_circles(std::move(other_circle_physics.touching_circles)) {
+    id(other_circle_physics.id),
+    contact_graph(other_circle_physics.contact_graph),
+    contact_registry(other_circle_physics.contact_registry),
+    transform_cache(other_circle_physics.transform_cache),
+    resize_queue(other_circle_physics.resize_queue),
+    impulse_buffer(other_circle_physics.impulse_buffer),
+    radius_pending(other_circle_physics.radius_pending) {
 
     b2ShapeId shapeId;
     b2Body_GetShapes(bodyId, &shapeId, 1);
     b2Shape_SetUserData(shapeId, this);
+    b2Body_SetUserData(bodyId, this);
 
+    // Contacts are keyed by id, so the moved-to circle keeps them; the owner re-registers the new address.
     other_circle_physics.bodyId = b2BodyId{};
     other_circle_physics.kind = CircleKind::Unknown;
-
-    for (auto* touching_circle : touching_circles) {
-        touching_circle->remove_touching_circle(&other_circle_physics);
-        touching_circle->add_touching_circle(this);
-    }
+    other_circle_physics.id = CircleId{};
+    other_circle_physics.radius_pending = false;
 }
 
 CirclePhysics& CirclePhysics::operator=(CirclePhysics&& other_circle_physics) noexcept {
@@ -139,24 +224,42 @@ CirclePhysics& CirclePhysics::operator=(CirclePhysics&& other_circle_physics) no
     b2ShapeId shapeId;
     b2Body_GetShapes(bodyId, &shapeId, 1);
     b2Shape_SetUserData(shapeId, this);
+    b2Body_SetUserData(bodyId, this);
+
+    id = other_circle_physics.id;
+    contact_graph = other_circle_physics.contact_graph;
+    contact_registry = other_circle_physics.contact_registry;
+    transform_cache = other_circle_physics.transform_cache;
+    resize_queue = other_circle_physics.resize_queue;
+    impulse_buffer = other_circle_physics.impulse_buffer;
+    radius_pending = other_circle_physics.radius_pending;
 
     other_circle_physics.bodyId = b2BodyId{};
     other_circle_physics.kind = CircleKind::Unknown;
-
-    touching_circles = std::move(other_circle_physics.touching_circles);
-    for (auto* touching_circle : touching_circles) {
-        touching_circle->remove_touching_circle(&other_circle_physics);
-        touching_circle->add_touching_circle(this);
-    }
+    other_circle_physics.id = CircleId{};
+    other_circle_physics.radius_pending = false;
 
     return *this;
 }
 
 b2Vec2 CirclePhysics::getPosition() const {
+    if (transform_cache && transform_cache->has_transform(id)) {
+        return transform_cache->position(id);
+    }
     return b2Body_GetPosition(bodyId);
 }
 
+b2Rot CirclePhysics::getRotation() const {
+    if (transform_cache && transform_cache->has_transform(id)) {
+        return transform_cache->rotation(id);
+    }
+    return b2Body_GetRotation(bodyId);
+}
+
 b2Vec2 CirclePhysics::getLinearVelocity() const {
+    if (transform_cache && transform_cache->has_velocity(id)) {
+        return transform_cache->linear_velocity(id);
+    }
     return b2Body_GetLinearVelocity(bodyId);
 }
 
@@ -202,73 +305,120 @@ void CirclePhysics::apply_zero_torque() const {
 };
 
 void CirclePhysics::apply_forward_impulse() const {
-    b2Rot rotation = b2Body_GetRotation(bodyId);
+    b2Rot rotation = getRotation();
     b2Vec2 impulse = {linearImpulseMagnitude * rotation.c, linearImpulseMagnitude * rotation.s};
-    b2Body_ApplyLinearImpulse(bodyId, impulse, b2Body_GetPosition(bodyId), true);
+    if (impulse_buffer) {
+        impulse_buffer->push_linear(bodyId, impulse);
+    } else {
+        b2Body_ApplyLinearImpulseToCenter(bodyId, impulse, true);
+    }
+    invalidate_cached_velocity();
 };
 
 void CirclePhysics::apply_forward_impulse_at_point(const b2Vec2& world_point) const {
-    b2Rot rotation = b2Body_GetRotation(bodyId);
+    b2Rot rotation = getRotation();
     b2Vec2 impulse = {linearImpulseMagnitude * rotation.c, linearImpulseMagnitude * rotation.s};
-    b2Body_ApplyLinearImpulse(bodyId, impulse, world_point, true);
+    if (impulse_buffer) {
+        impulse_buffer->push_linear_at_point(bodyId, impulse, world_point);
+    } else {
+        b2Body_ApplyLinearImpulse(bodyId, impulse, world_point, true);
+    }
+    invalidate_cached_velocity();
 };
 
 void CirclePhysics::apply_left_turn_impulse() const {
+    if (impulse_buffer) {
+        impulse_buffer->push_angular(bodyId, -angularImpulseMagnitude);
+        return;
+    }
     b2Body_ApplyAngularImpulse(bodyId, -angularImpulseMagnitude, true);
 };
 
 void CirclePhysics::apply_right_turn_impulse() const {
+    if (impulse_buffer) {
+        impulse_buffer->push_angular(bodyId, angularImpulseMagnitude);
+        return;
+    }
     b2Body_ApplyAngularImpulse(bodyId, angularImpulseMagnitude, true);
 };
 
 float CirclePhysics::getAngle() const {
-    return b2Rot_GetAngle(b2Body_GetRotation(bodyId));
+    return b2Rot_GetAngle(getRotation());
 }
 
-void CirclePhysics::add_touching_circle(CirclePhysics* circle_physics) {
-    touching_circles.insert(circle_physics);
+void CirclePhysics::set_contact_store(const ContactGraph& graph, const CircleRegistry& registry) {
+    contact_graph = &graph;
+    contact_registry = &registry;
 }
 
-void CirclePhysics::remove_touching_circle(CirclePhysics* circle_physics) {
-    touching_circles.erase(circle_physics);
+void CirclePhysics::set_transform_cache(BodyTransformCache& cache) {
+    transform_cache = &cache;
+    refresh_cached_transform();
+}
+
+void CirclePhysics::refresh_cached_transform() const {
+    if (!transform_cache || id.value == 0 || !b2Body_IsValid(bodyId)) {
+        return;
+    }
+    transform_cache->store(id, b2Body_GetPosition(bodyId), b2Body_GetRotation(bodyId), b2Body_GetLinearVelocity(bodyId));
+}
+
+void CirclePhysics::invalidate_cached_velocity() const {
+    if (transform_cache) {
+        transform_cache->invalidate_velocity(id);
+    }
 }
 
 void CirclePhysics::for_each_touching(const std::function<void(CirclePhysics&)>& fn) {
-    for (auto* c : touching_circles) {
-        if (c) {
+    if (!contact_graph || !contact_registry) {
+        return;
+    }
+    contact_graph->for_each_neighbor(id, [&](CircleId neighbor) {
+        if (auto* c = contact_registry->get_physics(neighbor)) {
             fn(*c);
         }
-    }
+    });
 }
 
 void CirclePhysics::for_each_touching(const std::function<void(const CirclePhysics&)>& fn) const {
-    for (auto* c : touching_circles) {
-        if (c) {
+    if (!contact_graph || !contact_registry) {
+        return;
+    }
+    contact_graph->for_each_neighbor(id, [&](CircleId neighbor) {
+        if (const auto* c = contact_registry->get_physics(neighbor)) {
             fn(*c);
         }
-    }
+    });
 }
 
 void CirclePhysics::for_each_touching_drawable(const std::function<void(const DrawableCircle&)>& fn) const {
-    for (auto* c : touching_circles) {
-        if (!c) {
-            continue;
-        }
-        if (auto* drawable = dynamic_cast<const DrawableCircle*>(c)) {
+    if (!contact_graph || !contact_registry) {
+        return;
+    }
+    contact_graph->for_each_neighbor(id, [&](CircleId neighbor) {
+        if (const auto* drawable = contact_registry->get_drawable(neighbor)) {
             fn(*drawable);
         }
-    }
+    });
 }
 
 void CirclePhysics::for_each_touching_eatable(const std::function<void(EatableCircle&)>& fn) {
-    for (auto* c : touching_circles) {
-        if (!c) {
-            continue;
-        }
-        if (auto* eatable = dynamic_cast<EatableCircle*>(c)) {
+    if (!contact_graph || !contact_registry) {
+        return;
+    }
+    contact_graph->for_each_neighbor(id, [&](CircleId neighbor) {
+        if (auto* eatable = contact_registry->get_eatable(neighbor)) {
             fn(*eatable);
         }
-    }
+    });
+}
+
+void CirclePhysics::set_resize_queue(ShapeResizeQueue& queue) {
+    resize_queue = &queue;
+}
+
+void CirclePhysics::set_impulse_buffer(ImpulseCommandBuffer& buffer) {
+    impulse_buffer = &buffer;
 }
 
 void CirclePhysics::setRadius(float new_radius, const b2WorldId &worldId) {
@@ -277,14 +427,28 @@ void CirclePhysics::setRadius(float new_radius, const b2WorldId &worldId) {
     if (!b2Body_IsValid(bodyId)) return;
 
     set_cached_radius(new_radius);
+    if (resize_queue && id.value != 0) {
+        resize_queue->request(id, radius_pending);
+        radius_pending = true;
+        return;
+    }
+    radius_pending = true;
+    apply_pending_radius();
+}
+
+bool CirclePhysics::apply_pending_radius() {
+    if (!radius_pending) return false;
+    radius_pending = false;
+    if (!b2Body_IsValid(bodyId)) return false;
 
     b2ShapeId shapeId;
     b2Body_GetShapes(bodyId, &shapeId, 1);
-    if (!b2Shape_IsValid(shapeId)) return;
+    if (!b2Shape_IsValid(shapeId)) return false;
 
     b2Circle circle = b2Shape_GetCircle(shapeId);
-    circle.radius = new_radius;
+    circle.radius = getRadius();
     b2Shape_SetCircle(shapeId, &circle);
+    return true;
 }
 
 void CirclePhysics::setArea(float area, const b2WorldId &worldId) {
@@ -300,16 +464,16 @@ void CirclePhysics::setPosition(const b2Vec2& new_position, const b2WorldId &wor
     (void)worldId;
     if (!b2Body_IsValid(bodyId)) return;
 
-    b2Rot currentRot = b2Body_GetRotation(bodyId);
-    b2Body_SetTransform(bodyId, new_position, currentRot);
+    b2Body_SetTransform(bodyId, new_position, getRotation());
+    refresh_cached_transform();
 }
 
 void CirclePhysics::setAngle(float new_angle, const b2WorldId &worldId) {
     (void)worldId;
     if (!b2Body_IsValid(bodyId)) return;
 
-    b2Vec2 currentPos = b2Body_GetPosition(bodyId);
-    b2Body_SetTransform(bodyId, currentPos, b2MakeRot(new_angle));
+    b2Body_SetTransform(bodyId, getPosition(), b2MakeRot(new_angle));
+    refresh_cached_transform();
 }
 
 void CirclePhysics::set_density(float new_density, const b2WorldId& worldId) {
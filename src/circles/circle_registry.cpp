@@ -0,0 +1,37 @@
+#include "circles/circle_registry.hpp"
+#include "circles/drawable_circle.hpp"
+#include "circles/eatable_circle.hpp"
+
+bool CircleRegistry::register_circle(CirclePhysics& circle) {
+    std::uint32_t slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        // Past kSlotMask the slot would spill into the generation bits and alias another circle's id.
+        if (entries.size() > CircleId::kSlotMask) {
+            return false;
+        }
+        slot = static_cast<std::uint32_t>(entries.size());
+        entries.emplace_back();
+    }
+
+    Entry& entry = entries[slot];
+    entry.physics = &circle;
+    entry.capabilities = 0;
+    if ((entry.senseable = dynamic_cast<ISenseable*>(&circle))) {
+        entry.capabilities |= CapabilitySenseable;
+    }
+    if ((entry.edible = dynamic_cast<IEdible*>(&circle))) {
+        entry.capabilities |= CapabilityEdible;
+    }
+    if ((entry.drawable = dynamic_cast<const DrawableCircle*>(&circle))) {
+        entry.capabilities |= CapabilityDrawable;
+    }
+    if ((entry.eatable = dynamic_cast<EatableCircle*>(&circle))) {
+        entry.capabilities |= CapabilityEatable;
+    }
+    circle.id = CircleId::make(slot, entry.generation);
+    ++live;
+    return true;
+}
@@ -31,6 +31,11 @@ void EatableCircle::be_eaten() {
     // eaten_by is set by the creature that consumed us (if applicable).
 }
 
+void EatableCircle::edible_mark_eaten(CreatureCircle* eater) {
+    be_eaten();
+    set_eaten_by(eater ? eater->get_id() : CircleId{});
+}
+
 bool EatableCircle::is_eaten() const {
     return eaten;
 }
@@ -0,0 +1,104 @@
+#include "circles/pellet_store.hpp"
+
+namespace {
+// Bounds the grid to 1024 x 1024 cells however large the dish gets.
+constexpr std::uint32_t kMaxDim = 1024;
+} // namespace
+
+PelletStore::PelletStore(float cell_size)
+    : cell_size(std::max(cell_size, 1e-3f)),
+      inv_cell_size(1.0f / std::max(cell_size, 1e-3f)) {}
+
+void PelletStore::set_extent(float new_half_extent) {
+    new_half_extent = std::max(new_half_extent, 0.0f);
+    const auto new_dim = std::clamp<std::uint32_t>(
+        static_cast<std::uint32_t>(std::ceil(2.0f * new_half_extent / cell_size)) + 1, 1, kMaxDim);
+    if (new_half_extent == half_extent && new_dim == dim) {
+        return;
+    }
+    half_extent = new_half_extent;
+    dim = new_dim;
+    cells.assign(static_cast<std::size_t>(dim) * dim, {});
+    for (std::uint32_t i = 0; i < x.size(); ++i) {
+        link(i);
+    }
+}
+
+std::uint32_t PelletStore::add(const b2Vec2& position, float radius, CircleKind pellet_kind) {
+    const auto i = static_cast<std::uint32_t>(x.size());
+    x.push_back(position.x);
+    y.push_back(position.y);
+    radii.push_back(radius);
+    kind.push_back(pellet_kind);
+    eaten.push_back(0);
+    cell.push_back(0);
+    cell_slot.push_back(0);
+    max_radius = std::max(max_radius, radius);
+    link(i);
+    return i;
+}
+
+void PelletStore::clear() {
+    x.clear();
+    y.clear();
+    radii.clear();
+    kind.clear();
+    eaten.clear();
+    cell.clear();
+    cell_slot.clear();
+    for (auto& list : cells) {
+        list.clear();
+    }
+    max_radius = 0.0f;
+}
+
+void PelletStore::link(std::uint32_t i) {
+    cell[i] = cell_of(x[i], y[i]);
+    auto& list = cells[cell[i]];
+    cell_slot[i] = static_cast<std::uint32_t>(list.size());
+    list.push_back(i);
+}
+
+void PelletStore::unlink(std::uint32_t i) {
+    auto& list = cells[cell[i]];
+    const std::uint32_t moved = list.back();
+    list[cell_slot[i]] = moved;
+    cell_slot[moved] = cell_slot[i];
+    list.pop_back();
+}
+
+void PelletStore::remove_at(std::uint32_t i) {
+    unlink(i);
+    const auto last = static_cast<std::uint32_t>(x.size() - 1);
+    if (i != last) {
+        x[i] = x[last];
+        y[i] = y[last];
+        radii[i] = radii[last];
+        kind[i] = kind[last];
+        eaten[i] = eaten[last];
+        cell[i] = cell[last];
+        cell_slot[i] = cell_slot[last];
+        cells[cell[i]][cell_slot[i]] = i;
+    }
+    x.pop_back();
+    y.pop_back();
+    radii.pop_back();
+    kind.pop_back();
+    eaten.pop_back();
+    cell.pop_back();
+    cell_slot.pop_back();
+}
+
+const std::array<float, 3>& PelletStore::color_for_kind(CircleKind pellet_kind) {
+    static const std::array<float, 3> food{0.0f, 1.0f, 0.0f};
+    static const std::array<float, 3> toxic{1.0f, 0.0f, 0.0f};
+    static const std::array<float, 3> division{0.0f, 0.0f, 1.0f};
+    switch (pellet_kind) {
+        case CircleKind::ToxicPellet:
+            return toxic;
+        case CircleKind::DivisionPellet:
+            return division;
+        default:
+            return food;
+    }
+}
@@ -0,0 +1,67 @@
+#include "circles/spatial_grid.hpp"
+
+SpatialGrid::SpatialGrid(float cell_size)
+    : cell_size(std::max(cell_size, 1e-3f)),
+      inv_cell_size(1.0f / std::max(cell_size, 1e-3f)) {}
+
+void SpatialGrid::clear() {
+    items.clear();
+    cell_x.clear();
+    cell_y.clear();
+    bucket_start.assign(2, 0);
+    bucket_mask = 0;
+    pending.clear();
+    max_radius = 0.0f;
+    min_cell_x = min_cell_y = 0;
+    max_cell_x = max_cell_y = -1;
+}
+
+void SpatialGrid::rebuild(std::vector<Item> new_items) {
+    clear();
+    if (new_items.empty()) {
+        return;
+    }
+
+    // Power-of-two bucket count at least the item count keeps chains short without a modulo.
+    std::size_t bucket_count = 1;
+    while (bucket_count < new_items.size()) {
+        bucket_count <<= 1;
+    }
+    bucket_mask = bucket_count - 1;
+
+    min_cell_x = min_cell_y = std::numeric_limits<int>::max();
+    max_cell_x = max_cell_y = std::numeric_limits<int>::min();
+    std::vector<std::size_t> buckets(new_items.size());
+    bucket_start.assign(bucket_count + 1, 0);
+    for (std::size_t i = 0; i < new_items.size(); ++i) {
+        const Item& item = new_items[i];
+        const int x = cell_coord(item.position.x);
+        const int y = cell_coord(item.position.y);
+        min_cell_x = std::min(min_cell_x, x);
+        max_cell_x = std::max(max_cell_x, x);
+        min_cell_y = std::min(min_cell_y, y);
+        max_cell_y = std::max(max_cell_y, y);
+        max_radius = std::max(max_radius, item.radius);
+        buckets[i] = bucket_of(x, y);
+        ++bucket_start[buckets[i] + 1];
+    }
+    for (std::size_t b = 0; b < bucket_count; ++b) {
+        bucket_start[b + 1] += bucket_start[b];
+    }
+
+    // Counting sort by bucket.
+    items.resize(new_items.size());
+    cell_x.resize(new_items.size());
+    cell_y.resize(new_items.size());
+    std::vector<std::uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+    for (std::size_t i = 0; i < new_items.size(); ++i) {
+        const std::uint32_t slot = cursor[buckets[i]]++;
+        items[slot] = new_items[i];
+        cell_x[slot] = cell_coord(new_items[i].position.x);
+        cell_y[slot] = cell_coord(new_items[i].position.y);
+    }
+}
+
+void SpatialGrid::insert(const Item& item) {
+    pending.push_back(item);
+}
@@ -15,9 +15,12 @@ CreatureCircle::CreatureCircle(const b2WorldId &worldId,
                          float init_add_connection_thresh,
                          const neat::Genome* base_brain,
                          std::vector<std::vector<int>>* innov_ids,
-                         int* last_innov_id) :
+                         int* last_innov_id,
+                         int color_sensor_count) :
     EatableCircle(worldId, position_x, position_y, radius, density, /*toxic=*/false, /*division_pellet=*/false, angle, /*boost_particle=*/false),
-    brain(base_brain ? *base_brain : neat::Genome(BRAIN_INPUTS, BRAIN_OUTPUTS, innov_ids, last_innov_id, 0.001f, false)) {
+    sensor_count(is_supported_color_sensor_count(color_sensor_count) ? color_sensor_count : kColorSensorCount),
+    sensor_pipeline(select_sensor_pipeline(sensor_count)),
+    brain(base_brain ? *base_brain : neat::Genome(brain_input_count_for(sensor_count), BRAIN_OUTPUTS, innov_ids, last_innov_id, 0.001f, false)) {
     set_kind(CircleKind::Creature);
     neat_innovations = innov_ids;
     neat_last_innov_id = last_innov_id;
@@ -30,9 +33,17 @@ CreatureCircle::CreatureCircle(const b2WorldId &worldId,
     smooth_display_color(1.0f); // start display at brain-driven color immediately
 }
 
-void CreatureCircle::set_contact_context(ContactGraph& graph, CircleRegistry& registry, float petri_radius) {
+void CreatureCircle::set_contact_context(ContactGraph& graph,
+                                         CircleRegistry& registry,
+                                         const ContactGeometryCache& geometry,
+                                         const SpatialGrid& grid,
+                                         PelletStore& pellets,
+                                         float petri_radius) {
     contacts.graph = &graph;
     contacts.registry = &registry;
+    contacts.geometry = &geometry;
+    contacts.grid = &grid;
+    contacts.pellets = &pellets;
     contacts.petri_radius = petri_radius;
 }
 
@@ -61,4 +72,5 @@ void CreatureCircle::initialize_brain(int mutation_rounds, float add_node_thresh
                 add_node_iters);
         }
     }
+    invalidate_brain_cache();
 }
@@ -1,29 +1,38 @@
 #include "creatures/creature_circle.hpp"
 #include "circles/drawable_circle.hpp"
+#include "creatures/sensor_geometry.hpp"
 #include "game/game.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 
 namespace {
 constexpr float PI = 3.14159f;
 constexpr float TWO_PI = PI * 2.0f;
-constexpr int SENSOR_COUNT = kColorSensorCount;
-static_assert(SENSOR_COUNT >= kMinColorSensorCount && SENSOR_COUNT <= kMaxColorSensorCount, "Color sensor count out of supported range.");
-constexpr float SECTOR_WIDTH = TWO_PI / static_cast<float>(SENSOR_COUNT);
-constexpr float SECTOR_HALF = SECTOR_WIDTH * 0.5f;
 
 using SectorSegment = std::pair<float, float>;
 struct SpanSegments {
     std::array<SectorSegment, 2> segments{};
     int count = 0;
 };
-using SectorSegments = std::array<SpanSegments, SENSOR_COUNT>;
-using SensorColors = std::array<std::array<float, 3>, SENSOR_COUNT>;
-using SensorWeights = std::array<float, SENSOR_COUNT>;
+template <int N>
+using SectorSegments = std::array<SpanSegments, N>;
+template <int N>
+using SensorColors = std::array<std::array<float, 3>, N>;
+template <int N>
+using SensorWeights = std::array<float, N>;
+template <int N>
+using SensorRing = sensor_geometry::SectorRing<N>;
+template <int N>
+using SensorTable = sensor_geometry::SectorOverlapTable<N>;
+template <int N>
+using WallTable = sensor_geometry::WallOverlapTable<N>;
+// Larger sensing disks see enough of the dish's curvature that the straight-wall table is off; they clip against it.
+constexpr float WALL_TABLE_MAX_RADIUS_RATIO = 0.125f;
 
 float neat_activation(float x) {
     return 1.0f / (1.0f + std::exp(-x));
@@ -54,12 +63,14 @@ SpanSegments split_interval(float start, float end) {
     return segments;
 }
 
-const SectorSegments& get_sector_segments() {
-    static const SectorSegments sector_segments = []() {
-        SectorSegments result{};
-        for (int i = 0; i < SENSOR_COUNT; ++i) {
-            float s_start = -SECTOR_HALF + i * SECTOR_WIDTH;
-            float s_end = s_start + SECTOR_WIDTH;
+template <int N>
+const SectorSegments<N>& get_sector_segments() {
+    static const SectorSegments<N> sector_segments = []() {
+        constexpr float sector_width = TWO_PI / static_cast<float>(N);
+        SectorSegments<N> result{};
+        for (int i = 0; i < N; ++i) {
+            float s_start = -0.5f * sector_width + i * sector_width;
+            float s_end = s_start + sector_width;
             result[i] = split_interval(s_start, s_end);
         }
         return result;
@@ -67,203 +78,173 @@ const SectorSegments& get_sector_segments() {
     return sector_segments;
 }
 
-float cross(const b2Vec2& a, const b2Vec2& b) {
-    return a.x * b.y - a.y * b.x;
+template <int N>
+const SensorRing<N>& get_sensor_ring() {
+    static const SensorRing<N> ring = sensor_geometry::make_sector_ring<N>();
+    return ring;
 }
 
-float dot(const b2Vec2& a, const b2Vec2& b) {
-    return a.x * b.x + a.y * b.y;
+template <int N>
+const SensorTable<N>& get_sensor_table() {
+    static const SensorTable<N> table(get_sensor_ring<N>());
+    return table;
 }
 
-float triangle_circle_intersection_area(const b2Vec2& a, const b2Vec2& b, float radius) {
-    // Circle is centered at the origin in this helper.
-    const float r2 = radius * radius;
-    const float len_a2 = dot(a, a);
-    const float EPS = 1e-6f;
-
-    // If both vertices are effectively at the origin, there is no area.
-    if (len_a2 < EPS && dot(b, b) < EPS) {
-        return 0.0f;
-    }
-
-    struct ParamPoint {
-        float t;
-        b2Vec2 p;
+// Coverage of every sector at once by a circle at rel_world (world axes, relative to the sensing creature);
+// sectors the circle misses come back as (near) zero.
+template <int N>
+void sector_coverage(const b2Vec2& rel_world,
+                     float radius,
+                     float cos_h,
+                     float sin_h,
+                     const SensorRing<N>& ring,
+                     const SensorTable<N>* table,
+                     typename SensorRing<N>::Areas& areas) {
+    b2Vec2 rel_local{
+        cos_h * rel_world.x + sin_h * rel_world.y,
+        -sin_h * rel_world.x + cos_h * rel_world.y
     };
-    std::array<ParamPoint, 4> pts{};
-    int count = 0;
-    pts[count++] = {0.0f, a};
-
-    // Solve for intersections of segment ab with the circle.
-    b2Vec2 d{b.x - a.x, b.y - a.y};
-    float A = dot(d, d);
-    float B = 2.0f * dot(a, d);
-    float C = len_a2 - r2;
-    float disc = B * B - 4.0f * A * C;
-    if (disc >= 0.0f && A > EPS) {
-        float sqrt_disc = std::sqrt(disc);
-        float inv_denom = 0.5f / A;
-        float t1 = (-B - sqrt_disc) * inv_denom;
-        float t2 = (-B + sqrt_disc) * inv_denom;
-        if (t1 > t2) std::swap(t1, t2);
-        if (t1 > EPS && t1 < 1.0f - EPS) {
-            pts[count++] = {t1, b2Vec2{a.x + d.x * t1, a.y + d.y * t1}};
-        }
-        if (t2 > EPS && t2 < 1.0f - EPS && std::fabs(t2 - t1) > EPS) {
-            if (count < static_cast<int>(pts.size())) {
-                pts[count++] = {t2, b2Vec2{a.x + d.x * t2, a.y + d.y * t2}};
-            }
-        }
-    }
-
-    pts[count++] = {1.0f, b};
-    std::sort(pts.begin(), pts.begin() + count, [&](const ParamPoint& p1, const ParamPoint& p2) {
-        return p1.t < p2.t;
-    });
-
-    float area = 0.0f;
-    for (int i = 0; i + 1 < count; ++i) {
-        const b2Vec2& p = pts[i].p;
-        const b2Vec2& q = pts[i + 1].p;
-        b2Vec2 mid{0.5f * (p.x + q.x), 0.5f * (p.y + q.y)};
-        const float mid_len2 = dot(mid, mid);
-        if (mid_len2 <= r2 + EPS) {
-            area += 0.5f * cross(p, q);
-        } else {
-            float ang = std::atan2(cross(p, q), dot(p, q));
-            area += 0.5f * r2 * ang;
-        }
-    }
-
-    return area;
-}
-
-float circle_triangle_intersection_area(const std::array<b2Vec2, 3>& poly, const b2Vec2& center, float radius) {
-    // Translate polygon so circle center is at the origin.
-    float area = 0.0f;
-    for (int i = 0; i < 3; ++i) {
-        b2Vec2 a{poly[i].x - center.x, poly[i].y - center.y};
-        const auto& next = poly[(i + 1) % 3];
-        b2Vec2 b{next.x - center.x, next.y - center.y};
-        area += triangle_circle_intersection_area(a, b, radius);
-    }
-    return area;
-}
-
-float circle_wedge_overlap_area(const b2Vec2& circle_center_local, float radius, float start_angle, float end_angle) {
-    // Build a large triangle that represents the wedge; large enough to fully contain the circle footprint.
-    float dist_to_origin = std::sqrt(circle_center_local.x * circle_center_local.x + circle_center_local.y * circle_center_local.y);
-    float ray_length = dist_to_origin + radius + 1.0f; // add slack to guarantee containment
-
-    b2Vec2 p1{std::cos(start_angle) * ray_length, std::sin(start_angle) * ray_length};
-    b2Vec2 p2{std::cos(end_angle) * ray_length, std::sin(end_angle) * ray_length};
-    std::array<b2Vec2, 3> triangle{{b2Vec2{0.0f, 0.0f}, p1, p2}};
-
-    float area = circle_triangle_intersection_area(triangle, circle_center_local, radius);
-    return std::max(0.0f, area);
-}
-
-float normalize_angle_positive(float angle) {
-    float a = std::fmod(angle, TWO_PI);
-    if (a < 0.0f) {
-        a += TWO_PI;
+    if (table) {
+        table->overlap(rel_local, radius, areas);
+    } else {
+        sensor_geometry::circle_sector_ring_overlap(rel_local, radius, ring, areas);
     }
-    return a;
 }
 
-void accumulate_touching_circle(const CirclePhysics& circle,
-                                const DrawableCircle& drawable,
-                                const b2Vec2& self_pos,
+template <int N>
+void accumulate_touching_circle(const b2Vec2& offset,
+                                float other_radius,
+                                const std::array<float, 3>& color,
                                 float cos_h,
                                 float sin_h,
-                                const SectorSegments& sector_segments,
-                                SensorColors& summed_colors,
-                                SensorWeights& weights) {
-    const b2Vec2 other_pos = circle.getPosition();
-    b2Vec2 rel_world{other_pos.x - self_pos.x, other_pos.y - self_pos.y};
-    b2Vec2 rel_local{
-        cos_h * rel_world.x + sin_h * rel_world.y,
-        -sin_h * rel_world.x + cos_h * rel_world.y
-    };
-
-    const float other_r = circle.getRadius();
-    const float dist2 = rel_local.x * rel_local.x + rel_local.y * rel_local.y;
-    const float other_r2 = other_r * other_r;
-    const auto& color = drawable.get_color_rgb();
+                                const SensorRing<N>& ring,
+                                const SensorTable<N>* table,
+                                SensorColors<N>& summed_colors,
+                                SensorWeights<N>& weights) {
+    typename SensorRing<N>::Areas areas;
+    sector_coverage<N>(offset, other_radius, cos_h, sin_h, ring, table, areas);
+
+    for (int sector = 0; sector < N; ++sector) {
+        const float area_in_sector = areas[sector];
+        summed_colors[sector][0] += color[0] * area_in_sector;
+        summed_colors[sector][1] += color[1] * area_in_sector;
+        summed_colors[sector][2] += color[2] * area_in_sector;
+        weights[sector] += area_in_sector;
+    }
+}
 
-    const auto clamp_sector_index = [](int idx) {
-        return std::clamp(idx, 0, SENSOR_COUNT - 1);
+// Circles within vision_radius of the body's surface, found through the spatial grid instead of physics
+// contacts. Coverage is scaled by closeness: 1 while touching, falling linearly to 0 at the edge of vision.
+// Returns the number of circles considered.
+template <int N>
+int accumulate_visible_circles(const SpatialGrid& grid,
+                               const CircleRegistry& registry,
+                               const PelletStore* pellets,
+                               CircleId self_id,
+                               const b2Vec2& self_pos,
+                               float self_radius,
+                               float cos_h,
+                               float sin_h,
+                               float vision_radius,
+                               bool nearest_only,
+                               const SensorRing<N>& ring,
+                               const SensorTable<N>* table,
+                               SensorColors<N>& summed_colors,
+                               SensorWeights<N>& weights) {
+    struct Sighting {
+        float gap = std::numeric_limits<float>::max();
+        std::array<float, 3> color{};
+        float area = 0.0f;
     };
+    std::array<Sighting, N> nearest{};
+    int candidates = 0;
 
-    auto accumulate_sector = [&](int sector) {
-        const int clamped_sector = clamp_sector_index(sector);
-        float area_in_sector = 0.0f;
-        const auto& segs = sector_segments[clamped_sector];
-        for (int idx = 0; idx < segs.count; ++idx) {
-            const auto& seg = segs.segments[idx];
-            area_in_sector += circle_wedge_overlap_area(rel_local, other_r, seg.first, seg.second);
-        }
+    const auto see = [&](const b2Vec2& position, float radius, const std::array<float, 3>& color) {
+        ++candidates;
 
-        if (area_in_sector <= 0.0f) {
+        const b2Vec2 rel_world{position.x - self_pos.x, position.y - self_pos.y};
+        const float distance = std::sqrt(rel_world.x * rel_world.x + rel_world.y * rel_world.y);
+        const float gap = std::max(distance - self_radius - radius, 0.0f);
+        const float closeness = std::max(1.0f - gap / vision_radius, 0.0f);
+        if (closeness <= 0.0f) {
             return;
         }
 
-        summed_colors[clamped_sector][0] += color[0] * area_in_sector;
-        summed_colors[clamped_sector][1] += color[1] * area_in_sector;
-        summed_colors[clamped_sector][2] += color[2] * area_in_sector;
-        weights[clamped_sector] += area_in_sector;
+        typename SensorRing<N>::Areas areas;
+        sector_coverage<N>(rel_world, radius, cos_h, sin_h, ring, table, areas);
+        for (int sector = 0; sector < N; ++sector) {
+            const float seen = areas[sector] * closeness;
+            if (seen <= 0.0f) {
+                continue;
+            }
+            if (nearest_only) {
+                if (gap < nearest[sector].gap) {
+                    nearest[sector] = {gap, color, seen};
+                }
+                continue;
+            }
+            summed_colors[sector][0] += color[0] * seen;
+            summed_colors[sector][1] += color[1] * seen;
+            summed_colors[sector][2] += color[2] * seen;
+            weights[sector] += seen;
+        }
     };
 
-    if (dist2 <= other_r2) {
-        // Circle encompasses the origin; intersects all sectors.
-        for (int sector = 0; sector < SENSOR_COUNT; ++sector) {
-            accumulate_sector(sector);
+    grid.for_each_in_radius(self_pos, self_radius + vision_radius, [&](const SpatialGrid::Item& item) {
+        if (item.id == self_id) {
+            return;
         }
-        return;
+        const auto* entry = registry.find(item.id);
+        if (!entry || !entry->has(CapabilitySenseable) || !entry->has(CapabilityDrawable)) {
+            return;
+        }
+        see(item.position, item.radius, entry->drawable->get_color_rgb());
+    });
+    if (pellets) {
+        pellets->for_each_in_radius(self_pos, self_radius + vision_radius, [&](std::uint32_t i) {
+            if (!pellets->is_eaten(i)) {
+                see(pellets->position(i), pellets->radius(i), pellets->color(i));
+            }
+        });
     }
 
-    const float dist = std::sqrt(dist2);
-    const float half_span = std::asin(std::clamp(other_r / dist, 0.0f, 1.0f));
-    const float center_angle = std::atan2(rel_local.y, rel_local.x);
-    constexpr float pad = 1e-4f; // avoid missing boundary-touching sectors
-    float start = normalize_angle_positive(center_angle - half_span - pad);
-    float end = normalize_angle_positive(center_angle + half_span + pad);
-
-    auto angle_to_index = [&](float angle) {
-        int idx = static_cast<int>(std::floor(angle / SECTOR_WIDTH));
-        return clamp_sector_index(idx);
-    };
-
-    int start_idx = angle_to_index(start);
-    int end_idx = angle_to_index(end);
-
-    auto process_range = [&](int from, int to) {
-        for (int s = from; ; ++s) {
-            accumulate_sector(s);
-            if (s == to) break;
+    if (nearest_only) {
+        for (int sector = 0; sector < N; ++sector) {
+            const Sighting& sighting = nearest[sector];
+            summed_colors[sector][0] += sighting.color[0] * sighting.area;
+            summed_colors[sector][1] += sighting.color[1] * sighting.area;
+            summed_colors[sector][2] += sighting.color[2] * sighting.area;
+            weights[sector] += sighting.area;
         }
-    };
-
-    if (start <= end) {
-        process_range(start_idx, end_idx);
-    } else {
-        process_range(start_idx, SENSOR_COUNT - 1);
-        process_range(0, end_idx);
     }
+    return candidates;
 }
 
+template <int N>
+const WallTable<N>& get_wall_table() {
+    static const WallTable<N> table(get_sensor_ring<N>());
+    return table;
+}
+
+template <int N>
 void accumulate_outside_petri(const b2Vec2& self_pos,
                               float self_radius,
                               float cos_h,
                               float sin_h,
                               float petri_radius,
-                              const SectorSegments& sector_segments,
-                              SensorColors& summed_colors,
-                              SensorWeights& weights) {
+                              SensorColors<N>& summed_colors,
+                              SensorWeights<N>& weights) {
     if (petri_radius <= 0.0f || self_radius <= 0.0f) {
         return;
     }
 
+    // Only creatures within self_radius of the wall can see past it.
+    const float distance = std::sqrt(self_pos.x * self_pos.x + self_pos.y * self_pos.y);
+    const float gap = petri_radius - distance;
+    if (gap >= self_radius) {
+        return;
+    }
+
     // Petri dish is centered at the world origin.
     b2Vec2 rel_world{-self_pos.x, -self_pos.y};
     b2Vec2 dish_local{
@@ -271,124 +252,199 @@ void accumulate_outside_petri(const b2Vec2& self_pos,
         -sin_h * rel_world.x + cos_h * rel_world.y
     };
 
-    constexpr float epsilon = 1e-6f;
-    for (int sector = 0; sector < SENSOR_COUNT; ++sector) {
-        float outside_area = 0.0f;
-        const auto& segs = sector_segments[sector];
-        for (int idx = 0; idx < segs.count; ++idx) {
-            const auto& seg = segs.segments[idx];
-            float span = seg.second - seg.first;
-            if (span <= 0.0f) {
-                continue;
-            }
-
-            // Scale the ray length so the triangle area matches the circular sector area.
-            float sin_span = std::sin(span);
-            float ray_length = self_radius;
-            if (std::fabs(sin_span) > epsilon) {
-                ray_length = self_radius * std::sqrt(span / sin_span);
+    typename SensorRing<N>::Areas outside_areas{};
+    if (self_radius <= WALL_TABLE_MAX_RADIUS_RATIO * petri_radius && distance > 0.0f) {
+        const b2Vec2 outward_normal{-dish_local.x / distance, -dish_local.y / distance};
+        get_wall_table<N>().outside(outward_normal, gap, self_radius, outside_areas);
+    } else {
+        const auto& sector_segments = get_sector_segments<N>();
+        for (int sector = 0; sector < N; ++sector) {
+            const auto& segs = sector_segments[sector];
+            for (int idx = 0; idx < segs.count; ++idx) {
+                const auto& seg = segs.segments[idx];
+                outside_areas[sector] += sensor_geometry::sector_outside_circle_area(dish_local, petri_radius, self_radius, seg.first, seg.second);
             }
-
-            b2Vec2 p1{std::cos(seg.first) * ray_length, std::sin(seg.first) * ray_length};
-            b2Vec2 p2{std::cos(seg.second) * ray_length, std::sin(seg.second) * ray_length};
-            std::array<b2Vec2, 3> triangle{{b2Vec2{0.0f, 0.0f}, p1, p2}};
-
-            float inside_area = circle_triangle_intersection_area(triangle, dish_local, petri_radius);
-            float segment_area = 0.5f * self_radius * self_radius * span;
-            inside_area = std::clamp(inside_area, 0.0f, segment_area);
-
-            outside_area += segment_area - inside_area;
         }
+    }
 
+    for (int sector = 0; sector < N; ++sector) {
+        const float outside_area = outside_areas[sector];
         if (outside_area > 0.0f) {
             summed_colors[sector][0] += outside_area; // Sense outside as red.
             weights[sector] += outside_area;
         }
     }
 }
+
+// Normalized color per sensor, written as N consecutive RGB triples starting at inputs[0].
+template <int N>
+void write_sensor_inputs(const SensorColors<N>& summed_colors, const SensorWeights<N>& weights, float self_radius, float* inputs) {
+    // Order sensors clockwise starting from the forward-facing sector.
+    const float sector_area = (PI * self_radius * self_radius) / static_cast<float>(N);
+    for (int i = 0; i < N; ++i) {
+        int base_index = i * 3;
+        float weight = weights[i];
+        if (weight > 0.0f) {
+            float r_sum = summed_colors[i][0];
+            float g_sum = summed_colors[i][1];
+            float b_sum = summed_colors[i][2];
+            float denom_r = r_sum + sector_area;
+            float denom_g = g_sum + sector_area;
+            float denom_b = b_sum + sector_area;
+            inputs[base_index]     = denom_r > 0.0f ? (r_sum / denom_r) : 0.0f;
+            inputs[base_index + 1] = denom_g > 0.0f ? (g_sum / denom_g) : 0.0f;
+            inputs[base_index + 2] = denom_b > 0.0f ? (b_sum / denom_b) : 0.0f;
+        } else {
+            inputs[base_index]     = 0.0f;
+            inputs[base_index + 1] = 0.0f;
+            inputs[base_index + 2] = 0.0f;
+        }
+    }
+}
 } // namespace
 
+CreatureCircle::SensorPipeline CreatureCircle::select_sensor_pipeline(int sensor_count) {
+    switch (sensor_count) {
+        case 4: return &CreatureCircle::update_sensor_inputs<4>;
+        case 16: return &CreatureCircle::update_sensor_inputs<16>;
+        case 32: return &CreatureCircle::update_sensor_inputs<32>;
+        case 8:
+        default: return &CreatureCircle::update_sensor_inputs<8>;
+    }
+}
+
 void CreatureCircle::run_brain_cycle_from_touching() {
     update_brain_inputs_from_touching();
-    brain.loadInputs(brain_inputs.data());
-    brain.runNetwork(neat_activation);
-    brain.getOutputs(brain_outputs.data());
+    // The network is a pure feed-forward function of its inputs, so unchanged inputs reuse the last outputs.
+    last_brain_cycle_cached = behavior.brain_cache_enabled && brain_cache_valid && brain_inputs_match_cache();
+    if (!last_brain_cycle_cached) {
+        brain.loadInputs(brain_inputs.data());
+        brain.runNetwork(neat_activation);
+        brain.getOutputs(brain_outputs.data());
+        cached_brain_inputs = brain_inputs;
+        brain_cache_valid = true;
+    }
     update_color_from_brain();
 }
 
+void CreatureCircle::refresh_brain_size() {
+    brain_enabled_connections = brain.countEnabledConnections();
+    brain_enabled_hidden_nodes = brain.countEnabledHiddenNodes();
+}
+
+void CreatureCircle::apply_brain_metabolic_cost(const b2WorldId& worldId) {
+    const float cost = std::max(behavior.brain_cost_per_connection, 0.0f) * static_cast<float>(brain_enabled_connections) +
+                       std::max(behavior.brain_cost_per_node, 0.0f) * static_cast<float>(brain_enabled_hidden_nodes);
+    last_brain_metabolic_cost = cost;
+    if (cost <= 0.0f || is_eaten()) {
+        return;
+    }
+
+    const float new_area = getArea() - cost;
+    if (new_area > minimum_area) {
+        setArea(new_area, worldId);
+        return;
+    }
+    // Starved by its own brain: dies like poison so the remaining area returns as pellets.
+    poisoned = true;
+    this->be_eaten();
+}
+
+bool CreatureCircle::brain_inputs_match_cache() const {
+    const float epsilon = std::max(behavior.brain_cache_epsilon, 0.0f);
+    for (int i = 0; i < brain_input_count(); ++i) {
+        if (std::fabs(brain_inputs[i] - cached_brain_inputs[i]) > epsilon) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CreatureCircle::update_brain_inputs_from_touching() {
-    SensorColors summed_colors{};
-    SensorWeights weights{};
+    (this->*sensor_pipeline)();
+    write_size_and_memory_inputs();
+}
+
+template <int N>
+void CreatureCircle::update_sensor_inputs() {
+    SensorColors<N> summed_colors{};
+    SensorWeights<N> weights{};
 
     const b2Vec2 self_pos = this->getPosition();
     const float heading = this->getAngle();
     const float cos_h = std::cos(heading);
     const float sin_h = std::sin(heading);
-    const auto& sector_segments = get_sector_segments();
-
-    if (contacts.graph && contacts.registry) {
-        auto& graph = *contacts.graph;
+    const auto& sensor_ring = get_sensor_ring<N>();
+    const SensorTable<N>* sensor_table = behavior.sensor_mode == SensorMode::LookupTable ? &get_sensor_table<N>() : nullptr;
+
+    last_vision_candidates = 0;
+    if (behavior.vision_radius > 0.0f && contacts.grid && contacts.registry) {
+        last_vision_candidates = accumulate_visible_circles<N>(*contacts.grid,
+                                                               *contacts.registry,
+                                                               contacts.pellets,
+                                                               get_id(),
+                                                               self_pos,
+                                                               getRadius(),
+                                                               cos_h,
+                                                               sin_h,
+                                                               behavior.vision_radius,
+                                                               behavior.vision_summary == VisionSummary::Nearest,
+                                                               sensor_ring,
+                                                               sensor_table,
+                                                               summed_colors,
+                                                               weights);
+    } else if (contacts.geometry && contacts.registry) {
         auto& registry = *contacts.registry;
-        graph.for_each_neighbor(get_id(), [&](CircleId neighbor) {
-            const auto* senseable = registry.get_senseable(neighbor);
-            const auto* physics = registry.get_physics(neighbor);
-            if (!senseable || !physics) {
+        contacts.geometry->for_each_contact(get_id(), [&](const ContactGeometryCache::View& contact) {
+            const auto* entry = registry.find(contact.other);
+            if (!entry || !entry->has(CapabilitySenseable) || !entry->has(CapabilityDrawable)) {
                 return;
             }
-            auto* drawable = dynamic_cast<const DrawableCircle*>(physics);
-            if (!drawable) {
-                return;
-            }
-            accumulate_touching_circle(*physics,
-                                       *drawable,
-                                       self_pos,
-                                       cos_h,
-                                       sin_h,
-                                       sector_segments,
-                                       summed_colors,
-                                       weights);
+            accumulate_touching_circle<N>(contact.offset,
+                                          contact.other_radius,
+                                          entry->drawable->get_color_rgb(),
+                                          cos_h,
+                                          sin_h,
+                                          sensor_ring,
+                                          sensor_table,
+                                          summed_colors,
+                                          weights);
         });
+        if (contacts.pellets) {
+            const PelletStore& pellets = *contacts.pellets;
+            pellets.for_each_in_radius(self_pos, getRadius(), [&](std::uint32_t i) {
+                if (pellets.is_eaten(i)) {
+                    return;
+                }
+                const b2Vec2 p = pellets.position(i);
+                accumulate_touching_circle<N>(b2Vec2{p.x - self_pos.x, p.y - self_pos.y},
+                                              pellets.radius(i),
+                                              pellets.color(i),
+                                              cos_h,
+                                              sin_h,
+                                              sensor_ring,
+                                              sensor_table,
+                                              summed_colors,
+                                              weights);
+            });
+        }
     }
 
     if (contacts.petri_radius > 0.0f) {
-        accumulate_outside_petri(self_pos, getRadius(), cos_h, sin_h, contacts.petri_radius, sector_segments, summed_colors, weights);
+        accumulate_outside_petri<N>(self_pos, getRadius(), cos_h, sin_h, contacts.petri_radius, summed_colors, weights);
     }
 
-    apply_sensor_inputs(summed_colors, weights);
-    write_size_and_memory_inputs();
-}
-
-void CreatureCircle::apply_sensor_inputs(const std::array<std::array<float, 3>, SENSOR_COUNT>& summed_colors, const std::array<float, SENSOR_COUNT>& weights) {
-    // Order sensors clockwise starting from the forward-facing sector.
-    const float sector_area = (PI * getRadius() * getRadius()) / static_cast<float>(SENSOR_COUNT);
-    for (int i = 0; i < SENSOR_COUNT; ++i) {
-        int base_index = i * 3;
-        float weight = weights[i];
-        if (weight > 0.0f) {
-            float r_sum = summed_colors[i][0];
-            float g_sum = summed_colors[i][1];
-            float b_sum = summed_colors[i][2];
-            float denom_r = r_sum + sector_area;
-            float denom_g = g_sum + sector_area;
-            float denom_b = b_sum + sector_area;
-            brain_inputs[base_index]     = denom_r > 0.0f ? (r_sum / denom_r) : 0.0f;
-            brain_inputs[base_index + 1] = denom_g > 0.0f ? (g_sum / denom_g) : 0.0f;
-            brain_inputs[base_index + 2] = denom_b > 0.0f ? (b_sum / denom_b) : 0.0f;
-        } else {
-            brain_inputs[base_index]     = 0.0f;
-            brain_inputs[base_index + 1] = 0.0f;
-            brain_inputs[base_index + 2] = 0.0f;
-        }
-    }
+    write_sensor_inputs<N>(summed_colors, weights, getRadius(), brain_inputs.data());
 }
 
 void CreatureCircle::write_size_and_memory_inputs() {
     float area = this->getArea();
     float normalized = area / (area + 10.0f); // gentler saturation for larger sizes
-    brain_inputs[SIZE_INPUT_INDEX] = normalized;
+    const int size_input_index = sensor_count * 3;
+    brain_inputs[size_input_index] = normalized;
 
     for (int i = 0; i < MEMORY_SLOTS; ++i) {
-        brain_inputs[MEMORY_INPUT_START + i] = memory_state[i];
+        brain_inputs[size_input_index + 1 + i] = memory_state[i];
     }
 }
 
@@ -8,54 +8,33 @@
 
 namespace {
 constexpr float PI = 3.14159f;
-
-float calculate_overlap_area(float r1, float r2, float distance) {
-    if (distance >= r1 + r2) return 0.0f;
-    if (distance <= fabs(r1 - r2)) return PI * fmin(r1, r2) * fmin(r1, r2);
-
-    float r_sq1 = r1 * r1;
-    float r_sq2 = r2 * r2;
-    float d_sq = distance * distance;
-
-    float clamp1 = std::clamp((d_sq + r_sq1 - r_sq2) / (2.0f * distance * r1), -1.0f, 1.0f);
-    float clamp2 = std::clamp((d_sq + r_sq2 - r_sq1) / (2.0f * distance * r2), -1.0f, 1.0f);
-
-    float part1 = r_sq1 * acos(clamp1);
-    float part2 = r_sq2 * acos(clamp2);
-    float part3 = 0.5f * sqrt((r1 + r2 - distance) * (r1 - r2 + distance) * (-r1 + r2 + distance) * (r1 + r2 + distance));
-
-    return part1 + part2 - part3;
-}
 } // namespace
 
 void CreatureCircle::process_eating(const b2WorldId &worldId, Game& game, float poison_death_probability_toxic, float poison_death_probability_normal) {
     poisoned = false;
-    if (contacts.graph && contacts.registry) {
-        auto& graph = *contacts.graph;
+    if (contacts.geometry && contacts.registry) {
         auto& registry = *contacts.registry;
-        graph.for_each_neighbor(get_id(), [&](CircleId neighbor) {
-            auto* edible = registry.get_edible(neighbor);
-            auto* touching_circle = registry.get_physics(neighbor);
-            if (!edible || !touching_circle) {
-                return;
-            }
-            if (!can_eat_circle(*touching_circle)) {
+        contacts.geometry->for_each_contact(get_id(), [&](const ContactGeometryCache::View& contact) {
+            const auto* entry = registry.find(contact.other);
+            if (!entry || !entry->has(CapabilityEdible) || !entry->has(CapabilityEatable)) {
                 return;
             }
-            if (edible->edible_is_eaten()) {
+            if (!can_eat_circle(*entry->physics)) {
                 return;
             }
-            if (!has_overlap_to_eat(*touching_circle)) {
+            if (entry->edible->edible_is_eaten()) {
                 return;
             }
-            float touching_area = edible->edible_area();
-            auto* eatable_circle = dynamic_cast<EatableCircle*>(touching_circle);
-            if (!eatable_circle) {
+            if (!has_overlap_to_eat(contact)) {
                 return;
             }
-            consume_touching_circle(worldId, game, *eatable_circle, touching_area, poison_death_probability_toxic, poison_death_probability_normal);
+            float touching_area = entry->edible->edible_area();
+            consume_touching_circle(worldId, game, *entry->eatable, touching_area, poison_death_probability_toxic, poison_death_probability_normal);
         });
     }
+    if (contacts.pellets) {
+        eat_stored_pellets(worldId, game, poison_death_probability_toxic, poison_death_probability_normal);
+    }
 
     if (poisoned) {
         this->be_eaten();
@@ -66,54 +45,56 @@ bool CreatureCircle::can_eat_circle(const CirclePhysics& circle) const {
     return circle.getRadius() < this->getRadius();
 }
 
-bool CreatureCircle::has_overlap_to_eat(const CirclePhysics& circle) const {
-    const float touching_area = circle.getArea();
+bool CreatureCircle::has_overlap_to_eat(const ContactGeometryCache::View& contact) const {
+    const float touching_area = PI * contact.other_radius * contact.other_radius;
     const float overlap_threshold = touching_area * 0.8f;
-
-    const float r_self = this->getRadius();
-    const float r_other = circle.getRadius();
-
-    const b2Vec2 self_pos = this->getPosition();
-    const b2Vec2 other_pos = circle.getPosition();
-    const float dx = self_pos.x - other_pos.x;
-    const float dy = self_pos.y - other_pos.y;
-    const float dist2 = dx * dx + dy * dy;
-
-    const float sum_r = r_self + r_other;
-    const float sum_r2 = sum_r * sum_r;
-    if (dist2 >= sum_r2) {
-        // No overlap possible.
-        return false;
-    }
-
-    const float diff_r = r_self - r_other;
-    const float diff_r2 = diff_r * diff_r;
-    if (dist2 <= diff_r2) {
+    if (contact.contained) {
         // Smaller circle fully contained; overlap is entire touching area.
         return touching_area >= overlap_threshold;
     }
+    return contact.overlap_area >= overlap_threshold;
+}
 
-    const float distance = std::sqrt(dist2);
-    float overlap_area = calculate_overlap_area(r_self, r_other, distance);
-
-    return overlap_area >= overlap_threshold;
+// Same rule as has_overlap_to_eat, against pellets in the PelletStore. Geometry is taken before the first
+// bite, like the contact snapshot the Box2D path reads.
+void CreatureCircle::eat_stored_pellets(const b2WorldId &worldId, Game& game, float poison_death_probability_toxic, float poison_death_probability_normal) {
+    PelletStore& pellets = *contacts.pellets;
+    const b2Vec2 self_pos = getPosition();
+    const float self_radius = getRadius();
+    pellets.for_each_in_radius(self_pos, self_radius, [&](std::uint32_t i) {
+        const float pellet_radius = pellets.radius(i);
+        if (pellets.is_eaten(i) || pellet_radius >= self_radius) {
+            return;
+        }
+        const b2Vec2 p = pellets.position(i);
+        const float distance = std::sqrt((p.x - self_pos.x) * (p.x - self_pos.x) + (p.y - self_pos.y) * (p.y - self_pos.y));
+        const float pellet_area = PI * pellet_radius * pellet_radius;
+        if (circle_overlap_area(self_radius, pellet_radius, distance) < pellet_area * 0.8f) {
+            return;
+        }
+        pellets.mark_eaten(i);
+        const CircleKind kind = pellets.kind_of(i);
+        digest(worldId, game, kind == CircleKind::ToxicPellet, kind == CircleKind::DivisionPellet, pellet_area, poison_death_probability_toxic, poison_death_probability_normal);
+    });
 }
 
 void CreatureCircle::consume_touching_circle(const b2WorldId &worldId, Game& game, EatableCircle& eatable, float touching_area, float poison_death_probability_toxic, float poison_death_probability_normal) {
+    eatable.be_eaten();
+    eatable.set_eaten_by(get_id());
+    digest(worldId, game, eatable.is_toxic(), eatable.is_division_pellet(), touching_area, poison_death_probability_toxic, poison_death_probability_normal);
+}
+
+void CreatureCircle::digest(const b2WorldId &worldId, Game& game, bool toxic, bool division_pellet, float touching_area, float poison_death_probability_toxic, float poison_death_probability_normal) {
     float roll = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
-    if (eatable.is_toxic()) {
+    if (toxic) {
         if (roll < poison_death_probability_toxic) {
             poisoned = true;
         }
-        eatable.be_eaten();
-        eatable.set_eaten_by(this);
     } else {
         if (roll < poison_death_probability_normal) {
             poisoned = true;
         }
-        eatable.be_eaten();
-        eatable.set_eaten_by(this);
-        if (eatable.is_division_pellet()) {
+        if (division_pellet) {
             float div_roll = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
             if (div_roll <= game.death.division_pellet_divide_probability) {
                 this->divide(worldId, game);
@@ -134,6 +115,13 @@ void CreatureCircle::divide(const b2WorldId &worldId, Game& game) {
 
     const float new_radius = std::sqrt(divided_area / PI);
     neat::Genome parent_brain_copy = brain;
+    if (CreatureCircle* mate = pick_mate()) {
+        // Area is the fitness signal: the larger partner contributes the child's topology.
+        brain.fitness = getArea();
+        mate->brain.fitness = mate->getArea();
+        parent_brain_copy = neat::Genome::crossover(brain, mate->brain);
+        ++game.profiler.matings_total;
+    }
 
     const b2Vec2 original_pos = this->getPosition();
     const float angle = this->getAngle();
@@ -157,6 +145,35 @@ void CreatureCircle::divide(const b2WorldId &worldId, Game& game) {
     game.population_mgr().add_circle(std::move(new_circle));
 }
 
+CreatureCircle* CreatureCircle::pick_mate() const {
+    if (division.mating_probability <= 0.0f || !contacts.graph || !contacts.registry) {
+        return nullptr;
+    }
+    float roll = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+    if (roll >= division.mating_probability) {
+        return nullptr;
+    }
+
+    // Reservoir-sample one touching creature so every partner is equally likely.
+    CreatureCircle* mate = nullptr;
+    int candidates = 0;
+    contacts.graph->for_each_neighbor(get_id(), [&](CircleId neighbor) {
+        const auto* entry = contacts.registry->find(neighbor);
+        if (!entry || entry->physics->get_kind() != CircleKind::Creature) {
+            return;
+        }
+        auto* creature = static_cast<CreatureCircle*>(entry->physics);
+        if (creature == this || creature->is_eaten()) {
+            return;
+        }
+        ++candidates;
+        if (std::rand() % candidates == 0) {
+            mate = creature;
+        }
+    });
+    return mate;
+}
+
 bool CreatureCircle::has_sufficient_area_for_division(float divided_area) const {
     return divided_area > minimum_area;
 }
@@ -190,7 +207,8 @@ std::unique_ptr<CreatureCircle> CreatureCircle::create_division_child(const b2Wo
         division.init_add_connection_thresh,
         &brain,
         game.get_neat_innovations(),
-        game.get_neat_last_innovation_id());
+        game.get_neat_last_innovation_id(),
+        sensor_count);
 
     if (new_circle) {
         configure_child_after_division(*new_circle, worldId, game, angle, parent_brain_copy);
@@ -213,12 +231,15 @@ void CreatureCircle::apply_post_division_updates(Game& game, CreatureCircle* chi
     this->apply_forward_impulse();
 
     mutate_lineage(child);
+    // The child is submitted when it is added; the parent's genome changed under its existing id.
+    game.population_submit_for_speciation(*this);
 
     update_color_from_brain();
 }
 
 void CreatureCircle::configure_child_after_division(CreatureCircle& child, const b2WorldId& worldId, const Game& game, float angle, const neat::Genome& parent_brain_copy) const {
     child.brain = parent_brain_copy;
+    child.invalidate_brain_cache();
     child.memory_state = memory_state;
     child.set_impulse_magnitudes(division.linear_impulse_magnitude, division.angular_impulse_magnitude);
     child.set_linear_damping(game.movement.linear_damping, worldId);
@@ -253,6 +274,7 @@ void CreatureCircle::mutate_lineage(CreatureCircle* child) {
                 division.disable_connection_thresh,
                 division.add_node_thresh,
                 add_node_iters);
+            invalidate_brain_cache();
         }
         if (child && child->neat_innovations && child->neat_last_innov_id) {
             child->brain.mutate(
@@ -267,6 +289,7 @@ void CreatureCircle::mutate_lineage(CreatureCircle* child) {
                 division.disable_connection_thresh,
                 division.add_node_thresh,
                 add_node_iters);
+            child->invalidate_brain_cache();
         }
     }
 }
@@ -33,13 +33,14 @@ void spawn_boost_particle(const b2WorldId& worldId,
     boost_circle_ptr->set_impulse_magnitudes(behavior.linear_impulse_magnitude * frac, behavior.angular_impulse_magnitude * frac);
     boost_circle_ptr->set_linear_damping(behavior.boost_particle_linear_damping, worldId);
     boost_circle_ptr->set_angular_damping(behavior.angular_damping, worldId);
+    // Launched before it is handed over: add_circle may drop it when the registry is full.
+    boost_circle_ptr->setAngle(angle + PI, worldId);
+    boost_circle_ptr->apply_forward_impulse();
     if (behavior.spawn_circle) {
         behavior.spawn_circle(std::move(boost_circle));
     } else {
         game.population_mgr().add_circle(std::move(boost_circle));
     }
-    boost_circle_ptr->setAngle(angle + PI, worldId);
-    boost_circle_ptr->apply_forward_impulse();
 }
 
 b2Vec2 compute_lateral_boost_position(const CreatureCircle& creature, bool to_right) {
@@ -77,6 +78,10 @@ void CreatureCircle::move_randomly(const b2WorldId &worldId, Game &game) {
 void CreatureCircle::move_intelligently(const b2WorldId &worldId, Game &game, float dt) {
     (void)dt;
     run_brain_cycle_from_touching();
+    apply_brain_metabolic_cost(worldId);
+    if (is_eaten()) {
+        return;
+    }
 
     if (behavior.selected_and_possessed) {
         if (behavior.left_key_down) {
@@ -116,6 +121,8 @@ void CreatureCircle::move_intelligently(const b2WorldId &worldId, Game &game, fl
             behavior.disable_connection_thresh,
             behavior.tick_add_node_thresh,
             behavior.max_iterations_find_node);
+        invalidate_brain_cache();
+        game.population_submit_for_speciation(*this);
     }
 
     // Update memory from dedicated memory outputs (clamped).
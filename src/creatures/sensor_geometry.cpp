@@ -0,0 +1,192 @@
+#include "creatures/sensor_geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sensor_geometry {
+namespace {
+constexpr float PI = 3.14159265f;
+
+float cross(const b2Vec2& a, const b2Vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+float dot(const b2Vec2& a, const b2Vec2& b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+// Antiderivative of 2 * sqrt(r^2 - u^2): area of the circle strip between chord offsets 0 and u.
+float chord_integral(float u, float radius, float r2) {
+    u = std::clamp(u, -radius, radius);
+    return u * std::sqrt(std::max(r2 - u * u, 0.0f)) + r2 * std::asin(u / radius);
+}
+
+// Origin outside the circle: area of the circle swept clockwise of the ray dir, measured from the ray
+// through the circle's near side. Rays pointing away from the circle see all of it or none of it.
+float swept_area_outside(const b2Vec2& dir, const b2Vec2& center, float radius, float r2, float full_area) {
+    const float q = cross(dir, center);
+    if (dot(dir, center) < 0.0f) {
+        return q < 0.0f ? full_area : 0.0f;
+    }
+    return 0.5f * full_area - chord_integral(q, radius, r2);
+}
+
+// Origin inside the circle: polar-area antiderivative of rho(theta)^2 / 2 without the constant r^2 / 2 term.
+float swept_area_inside(const b2Vec2& dir, const b2Vec2& center, float radius, float r2) {
+    const float q = cross(dir, center);
+    const float d = dot(dir, center);
+    return -0.5f * (q * d + chord_integral(q, radius, r2));
+}
+
+float triangle_circle_intersection_area(const b2Vec2& a, const b2Vec2& b, float radius) {
+    // Circle is centered at the origin in this helper.
+    const float r2 = radius * radius;
+    const float len_a2 = dot(a, a);
+    const float EPS = 1e-6f;
+
+    // If both vertices are effectively at the origin, there is no area.
+    if (len_a2 < EPS && dot(b, b) < EPS) {
+        return 0.0f;
+    }
+
+    struct ParamPoint {
+        float t;
+        b2Vec2 p;
+    };
+    std::array<ParamPoint, 4> pts{};
+    int count = 0;
+    pts[count++] = {0.0f, a};
+
+    // Solve for intersections of segment ab with the circle.
+    b2Vec2 d{b.x - a.x, b.y - a.y};
+    float A = dot(d, d);
+    float B = 2.0f * dot(a, d);
+    float C = len_a2 - r2;
+    float disc = B * B - 4.0f * A * C;
+    if (disc >= 0.0f && A > EPS) {
+        float sqrt_disc = std::sqrt(disc);
+        float inv_denom = 0.5f / A;
+        float t1 = (-B - sqrt_disc) * inv_denom;
+        float t2 = (-B + sqrt_disc) * inv_denom;
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > EPS && t1 < 1.0f - EPS) {
+            pts[count++] = {t1, b2Vec2{a.x + d.x * t1, a.y + d.y * t1}};
+        }
+        if (t2 > EPS && t2 < 1.0f - EPS && std::fabs(t2 - t1) > EPS) {
+            if (count < static_cast<int>(pts.size())) {
+                pts[count++] = {t2, b2Vec2{a.x + d.x * t2, a.y + d.y * t2}};
+            }
+        }
+    }
+
+    pts[count++] = {1.0f, b};
+    std::sort(pts.begin(), pts.begin() + count, [&](const ParamPoint& p1, const ParamPoint& p2) {
+        return p1.t < p2.t;
+    });
+
+    float area = 0.0f;
+    for (int i = 0; i + 1 < count; ++i) {
+        const b2Vec2& p = pts[i].p;
+        const b2Vec2& q = pts[i + 1].p;
+        b2Vec2 mid{0.5f * (p.x + q.x), 0.5f * (p.y + q.y)};
+        const float mid_len2 = dot(mid, mid);
+        if (mid_len2 <= r2 + EPS) {
+            area += 0.5f * cross(p, q);
+        } else {
+            float ang = std::atan2(cross(p, q), dot(p, q));
+            area += 0.5f * r2 * ang;
+        }
+    }
+
+    return area;
+}
+} // namespace
+
+float circle_wedge_overlap_area(const b2Vec2& center, float radius, const b2Vec2& start_dir, const b2Vec2& end_dir, float width) {
+    if (radius <= 0.0f || width <= 0.0f) {
+        return 0.0f;
+    }
+    const float r2 = radius * radius;
+    const float full_area = PI * r2;
+
+    if (dot(center, center) <= r2) {
+        const float area = 0.5f * r2 * width +
+                           swept_area_inside(end_dir, center, radius, r2) -
+                           swept_area_inside(start_dir, center, radius, r2);
+        return std::clamp(area, 0.0f, full_area);
+    }
+
+    float area = swept_area_outside(end_dir, center, radius, r2, full_area) -
+                 swept_area_outside(start_dir, center, radius, r2, full_area);
+    // The swept area restarts at the ray pointing straight away from the circle; add a full turn when the
+    // wedge contains that direction.
+    if (cross(start_dir, center) < 0.0f && cross(center, end_dir) <= 0.0f) {
+        area += full_area;
+    }
+    return std::clamp(area, 0.0f, full_area);
+}
+
+float circle_wedge_overlap_area(const b2Vec2& center, float radius, float start_angle, float end_angle) {
+    const float width = end_angle - start_angle;
+    if (width >= 2.0f * PI) {
+        return radius > 0.0f ? PI * radius * radius : 0.0f;
+    }
+    if (width > PI) {
+        const float mid_angle = start_angle + 0.5f * width;
+        return circle_wedge_overlap_area(center, radius, start_angle, mid_angle) +
+               circle_wedge_overlap_area(center, radius, mid_angle, end_angle);
+    }
+    const b2Vec2 start_dir{std::cos(start_angle), std::sin(start_angle)};
+    const b2Vec2 end_dir{std::cos(end_angle), std::sin(end_angle)};
+    return circle_wedge_overlap_area(center, radius, start_dir, end_dir, width);
+}
+
+float circle_wedge_overlap_area_reference(const b2Vec2& center, float radius, float start_angle, float end_angle) {
+    // Build a large triangle that represents the wedge; large enough to fully contain the circle footprint.
+    float dist_to_origin = std::sqrt(center.x * center.x + center.y * center.y);
+    float ray_length = dist_to_origin + radius + 1.0f; // add slack to guarantee containment
+
+    b2Vec2 p1{std::cos(start_angle) * ray_length, std::sin(start_angle) * ray_length};
+    b2Vec2 p2{std::cos(end_angle) * ray_length, std::sin(end_angle) * ray_length};
+    std::array<b2Vec2, 3> triangle{{b2Vec2{0.0f, 0.0f}, p1, p2}};
+
+    float area = circle_triangle_intersection_area(triangle, center, radius);
+    return std::max(0.0f, area);
+}
+
+float sector_outside_circle_area(const b2Vec2& circle_center, float circle_radius, float self_radius, float start_angle, float end_angle) {
+    const float span = end_angle - start_angle;
+    if (span <= 0.0f || self_radius <= 0.0f) {
+        return 0.0f;
+    }
+
+    // Scale the ray length so the triangle area matches the circular sector area.
+    constexpr float epsilon = 1e-6f;
+    const float sin_span = std::sin(span);
+    float ray_length = self_radius;
+    if (std::fabs(sin_span) > epsilon) {
+        ray_length = self_radius * std::sqrt(span / sin_span);
+    }
+
+    const b2Vec2 p1{std::cos(start_angle) * ray_length, std::sin(start_angle) * ray_length};
+    const b2Vec2 p2{std::cos(end_angle) * ray_length, std::sin(end_angle) * ray_length};
+    const std::array<b2Vec2, 3> triangle{{b2Vec2{0.0f, 0.0f}, p1, p2}};
+
+    const float sector_area = 0.5f * self_radius * self_radius * span;
+    const float inside_area = std::clamp(circle_triangle_intersection_area(triangle, circle_center, circle_radius), 0.0f, sector_area);
+    return sector_area - inside_area;
+}
+
+float circle_triangle_intersection_area(const std::array<b2Vec2, 3>& poly, const b2Vec2& center, float radius) {
+    // Translate polygon so circle center is at the origin.
+    float area = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        b2Vec2 a{poly[i].x - center.x, poly[i].y - center.y};
+        const auto& next = poly[(i + 1) % 3];
+        b2Vec2 b{next.x - center.x, next.y - center.y};
+        area += triangle_circle_intersection_area(a, b, radius);
+    }
+    return area;
+}
+
+} // namespace sensor_geometry
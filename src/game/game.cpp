@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 
@@ -6,11 +7,13 @@
 #include "creatures/creature_circle.hpp"
 #include "game/game_components.hpp"
 
-Game::Game()
-    : selection(circles, timing.sim_time_accum),
+Game::Game(int color_sensor_count)
+    : selection(circles, timing.sim_time_accum, spatial_grid, circle_registry),
       spawner(*this) {
+    dish.color_sensor_count = is_supported_color_sensor_count(color_sensor_count) ? color_sensor_count : kColorSensorCount;
     b2WorldDef worldDef = b2DefaultWorldDef();
     worldDef.gravity = b2Vec2{0.0f, 0.0f};
+    worldDef.enableSleep = true;
     worldId = b2CreateWorld(&worldDef);
     age.dirty = true;
 
@@ -62,6 +65,13 @@ void Game::population_adjust_pellet_count(const EatableCircle* circle, int delta
     if (circle->is_boost_particle()) return;
     if (circle->get_kind() == CircleKind::Creature) return;
 
+    population_adjust_pellet_count(circle->is_division_pellet() ? CircleKind::DivisionPellet
+                                   : circle->is_toxic()         ? CircleKind::ToxicPellet
+                                                                : CircleKind::Pellet,
+                                   delta);
+}
+
+void Game::population_adjust_pellet_count(CircleKind kind, int delta) {
     auto apply = [&](std::size_t& counter) {
         if (delta > 0) {
             counter += static_cast<std::size_t>(delta);
@@ -71,11 +81,11 @@ void Game::population_adjust_pellet_count(const EatableCircle* circle, int delta
         }
     };
 
-    if (circle->is_division_pellet()) {
+    if (kind == CircleKind::DivisionPellet) {
         apply(pellets.division_count_cached);
-    } else if (circle->is_toxic()) {
+    } else if (kind == CircleKind::ToxicPellet) {
         apply(pellets.toxic_count_cached);
-    } else {
+    } else if (kind == CircleKind::Pellet) {
         apply(pellets.food_count_cached);
     }
 }
@@ -97,6 +107,25 @@ void Game::population_on_creature_added(const CreatureCircle& creature_circle) {
     }
 }
 
+void Game::population_submit_for_speciation(const CreatureCircle& creature_circle) {
+    if (speciation_settings.enabled) {
+        speciation.submit(creature_circle.get_id().value, creature_circle.get_brain());
+    }
+}
+
+void Game::set_speciation_enabled(bool enabled) {
+    const bool was_enabled = speciation_settings.enabled;
+    speciation_settings.enabled = enabled;
+    if (!enabled || was_enabled) {
+        return;
+    }
+    for (const auto& circle : circles) {
+        if (circle && circle->get_kind() == CircleKind::Creature) {
+            population_submit_for_speciation(static_cast<const CreatureCircle&>(*circle));
+        }
+    }
+}
+
 void Game::population_spawn_cloud(const CreatureCircle& creature, std::vector<std::unique_ptr<EatableCircle>>& out) {
     spawner.spawn_eatable_cloud(creature, out);
 }
@@ -132,6 +161,45 @@ void Game::draw(sf::RenderWindow& window) const {
     boundary.setFillColor(sf::Color::Transparent);
     window.draw(boundary);
 
+    if (pellet_store.size() > 0) {
+        // All stored pellets go out as one triangle list: a 12-gon fan per pellet, skipped when it lies
+        // outside the view. The half diagonal keeps the cull correct for rotated views.
+        constexpr int kPelletSegments = 12;
+        static const auto unit_circle = [] {
+            std::array<sf::Vector2f, kPelletSegments + 1> points{};
+            for (int k = 0; k <= kPelletSegments; ++k) {
+                const float a = 2.0f * 3.14159265f * static_cast<float>(k) / static_cast<float>(kPelletSegments);
+                points[k] = {std::cos(a), std::sin(a)};
+            }
+            return points;
+        }();
+        const sf::View& view = window.getView();
+        const sf::Vector2f view_center = view.getCenter();
+        const float view_reach = 0.5f * std::hypot(view.getSize().x, view.getSize().y);
+
+        pellet_vertices.clear();
+        pellet_store.for_each([&](std::uint32_t i) {
+            const b2Vec2 p = pellet_store.position(i);
+            const float r = pellet_store.radius(i);
+            if (std::abs(p.x - view_center.x) > view_reach + r || std::abs(p.y - view_center.y) > view_reach + r) {
+                return;
+            }
+            const auto& color = pellet_store.color(i);
+            const sf::Color fill{static_cast<std::uint8_t>(color[0] * 255.0f),
+                                 static_cast<std::uint8_t>(color[1] * 255.0f),
+                                 static_cast<std::uint8_t>(color[2] * 255.0f)};
+            const sf::Vector2f center{p.x, p.y};
+            for (int k = 0; k < kPelletSegments; ++k) {
+                pellet_vertices.push_back({center, fill});
+                pellet_vertices.push_back({center + unit_circle[k] * r, fill});
+                pellet_vertices.push_back({center + unit_circle[k + 1] * r, fill});
+            }
+        });
+        if (!pellet_vertices.empty()) {
+            window.draw(pellet_vertices.data(), pellet_vertices.size(), sf::PrimitiveType::Triangles);
+        }
+    }
+
     for (const auto& circle : circles) {
         circle->draw(window);
     }
@@ -3,6 +3,9 @@
 #include <numeric>
 #include <random>
 
+#include <neat/genome_corpus.hpp>
+#include <neat/genome_io.hpp>
+
 #include "game/game_components.hpp"
 
 #include "creatures/creature_circle.hpp"
@@ -12,20 +15,40 @@ GamePopulationManager::GamePopulationManager(Game& game_ref) : game(game_ref) {}
 
 namespace {
 void cleanup_circle(Game& game, EatableCircle& circle) {
+    if (circle.get_kind() == CircleKind::Creature) {
+        game.get_speciation().release(circle.get_id().value);
+    }
     game.get_contact_graph().remove_circle(circle.get_id());
     game.get_circle_registry().unregister_circle(circle);
 }
 } // namespace
 
 void GamePopulationManager::add_circle(std::unique_ptr<EatableCircle> circle) {
+    // Catch-all for pellets built as circles (e.g. a dead creature's cloud) while the lightweight tier is on.
+    if (circle && game.pellets.lightweight) {
+        const CircleKind kind = circle->get_kind();
+        if (kind == CircleKind::Pellet || kind == CircleKind::ToxicPellet || kind == CircleKind::DivisionPellet) {
+            add_pellet(circle->getPosition(), circle->getRadius(), kind);
+            return;
+        }
+    }
+    // A full registry refuses the circle instead of handing out an id that aliases another; it is dropped.
+    if (circle && !game.circle_registry.register_circle(*circle)) {
+        return;
+    }
     game.selection_controller->update_max_generation_from_circle(circle.get());
     adjust_pellet_count(circle.get(), 1);
     if (circle) {
-        game.circle_registry.register_capabilities(*circle);
+        circle->set_contact_store(game.contact_graph, game.circle_registry);
+        circle->set_transform_cache(game.body_transforms);
+        circle->set_resize_queue(game.shape_resizes);
+        circle->set_impulse_buffer(game.impulses);
+        game.spatial_grid.insert({circle->get_id(), circle->getPosition(), circle->getRadius(), circle->get_kind()});
     }
     if (circle && circle->get_kind() == CircleKind::Creature) {
         auto* creature_circle = static_cast<CreatureCircle*>(circle.get());
         game.population_on_creature_added(*creature_circle);
+        game.population_submit_for_speciation(*creature_circle);
     }
     if (circle && circle->get_kind() == CircleKind::Creature) {
         game.selection_controller->mark_selection_dirty();
@@ -33,6 +56,12 @@ void GamePopulationManager::add_circle(std::unique_ptr<EatableCircle> circle) {
     game.circles.push_back(std::move(circle));
 }
 
+void GamePopulationManager::add_pellet(const b2Vec2& position, float radius, CircleKind kind) {
+    game.pellet_store.set_extent(game.dish.radius);
+    game.pellet_store.add(position, radius, kind);
+    game.population_adjust_pellet_count(kind, 1);
+}
+
 std::size_t GamePopulationManager::get_creature_count() const {
     std::size_t count = 0;
     for (const auto& c : game.circles) {
@@ -43,6 +72,28 @@ std::size_t GamePopulationManager::get_creature_count() const {
     return count;
 }
 
+bool GamePopulationManager::export_brain_corpus(const std::string& path) const {
+    std::vector<const neat::Genome*> brains;
+    brains.reserve(game.circles.size());
+    for (const auto& c : game.circles) {
+        if (c && c->get_kind() == CircleKind::Creature) {
+            brains.push_back(&static_cast<const CreatureCircle*>(c.get())->get_brain());
+        }
+    }
+    return neat::saveGenomeCorpus(path, brains);
+}
+
+bool GamePopulationManager::export_brain_archive(const std::string& path) const {
+    std::vector<const neat::Genome*> brains;
+    brains.reserve(game.circles.size());
+    for (const auto& c : game.circles) {
+        if (c && c->get_kind() == CircleKind::Creature) {
+            brains.push_back(&static_cast<const CreatureCircle*>(c.get())->get_brain());
+        }
+    }
+    return neat::writeGenomeArchive(path, brains, &game.innovation.innovations);
+}
+
 GamePopulationManager::RemovalResult GamePopulationManager::evaluate_circle_removal(EatableCircle& circle, std::vector<std::unique_ptr<EatableCircle>>& spawned_cloud) {
     RemovalResult result{};
     if (circle.get_kind() == CircleKind::Creature) {
@@ -74,7 +125,7 @@ GamePopulationManager::CullState GamePopulationManager::collect_removal_state(co
         if (game.circles[i]->get_kind() == CircleKind::Creature) {
             state.removed_creature = true;
         }
-        if (selection_snapshot.circle && selection_snapshot.circle == game.circles[i].get()) {
+        if (selection_snapshot.id != CircleId{} && selection_snapshot.id == game.circles[i]->get_id()) {
             state.selected_was_removed = true;
             state.selected_killer = removal.killer;
         }
@@ -115,6 +166,7 @@ void GamePopulationManager::cull_consumed() {
     auto selection_snapshot = game.selection.capture_snapshot();
 
     CullState state = collect_removal_state(selection_snapshot, spawned_cloud);
+    remove_stored_pellets_if_eaten_or_outside(false);
 
     if (state.removed_any) {
         compact_circles(state.remove_mask);
@@ -137,8 +189,6 @@ void GamePopulationManager::erase_indices_descending(std::vector<std::size_t>& i
         return;
     }
 
-    auto snapshot = game.selection.capture_snapshot();
-
     std::sort(indices.begin(), indices.end(), std::greater<std::size_t>());
     indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
 
@@ -154,7 +204,7 @@ void GamePopulationManager::erase_indices_descending(std::vector<std::size_t>& i
         }
     }
 
-    game.selection.revalidate_selection(snapshot.circle);
+    game.selection.revalidate_selection();
     if (removed_creature) {
         game.selection_controller->mark_age_dirty();
         game.selection_controller->mark_selection_dirty();
@@ -162,15 +212,14 @@ void GamePopulationManager::erase_indices_descending(std::vector<std::size_t>& i
     game.selection_controller->refresh_generation_and_age();
 }
 
-bool GamePopulationManager::is_circle_outside_dish(const EatableCircle& circle, float dish_radius) const {
-    const double r = static_cast<double>(circle.getRadius());
+bool GamePopulationManager::is_circle_outside_dish(const b2Vec2& pos, float radius, float dish_radius) const {
+    const double r = static_cast<double>(radius);
     const double R = static_cast<double>(dish_radius);
 
     if (r <= 0.0 || R <= 0.0) {
         return false;
     }
 
-    const b2Vec2 pos = circle.getPosition();
     const double dist_sq = static_cast<double>(pos.x) * static_cast<double>(pos.x) +
                            static_cast<double>(pos.y) * static_cast<double>(pos.y);
     const double d = std::sqrt(dist_sq);
@@ -205,11 +254,11 @@ bool GamePopulationManager::handle_outside_removal(const std::unique_ptr<Eatable
                                   bool& selected_removed,
                                   bool& removed_creature) {
     float radius = circle->getRadius();
-    if (!is_circle_outside_dish(*circle, dish_radius)) {
+    if (!is_circle_outside_dish(circle->getPosition(), radius, dish_radius)) {
         return false;
     }
 
-    if (snapshot.circle && circle.get() == snapshot.circle) {
+    if (snapshot.id != CircleId{} && circle->get_id() == snapshot.id) {
         selected_removed = true;
     }
     if (radius < dish_radius && circle->get_kind() == CircleKind::Creature) {
@@ -219,7 +268,41 @@ bool GamePopulationManager::handle_outside_removal(const std::unique_ptr<Eatable
     return true;
 }
 
+void GamePopulationManager::remove_stored_pellets_if_eaten_or_outside(bool remove_outside) {
+    auto& store = game.pellet_store;
+    const float dish_radius = game.dish.radius;
+    store.remove_if(
+        [&](std::uint32_t i) {
+            return store.is_eaten(i) || (remove_outside && is_circle_outside_dish(store.position(i), store.radius(i), dish_radius));
+        },
+        [&](CircleKind kind) { game.population_adjust_pellet_count(kind, -1); });
+}
+
+void GamePopulationManager::remove_random_stored_pellets(float percentage, CircleKind kind, bool any_kind) {
+    auto& store = game.pellet_store;
+    std::vector<std::uint32_t> candidates;
+    store.for_each([&](std::uint32_t i) {
+        if (any_kind || store.kind_of(i) == kind) {
+            candidates.push_back(i);
+        }
+    });
+    std::size_t target = compute_target_removal_count(candidates.size(), percentage);
+    if (target == 0) {
+        return;
+    }
+
+    static std::mt19937 rng{std::random_device{}()};
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+    std::vector<char> remove_mask(store.size(), 0);
+    for (std::size_t i = 0; i < target; ++i) {
+        remove_mask[candidates[i]] = 1;
+    }
+    store.remove_if([&](std::uint32_t i) { return remove_mask[i] != 0; },
+                    [&](CircleKind removed) { game.population_adjust_pellet_count(removed, -1); });
+}
+
 void GamePopulationManager::remove_outside_petri() {
+    remove_stored_pellets_if_eaten_or_outside(true);
     if (game.circles.empty()) {
         return;
     }
@@ -242,7 +325,7 @@ void GamePopulationManager::remove_outside_petri() {
             }),
         game.circles.end());
 
-    game.selection.handle_selection_after_removal(snapshot, selected_removed, nullptr, snapshot.position);
+    game.selection.handle_selection_after_removal(snapshot, selected_removed, CircleId{}, snapshot.position);
     if (removed_creature) {
         game.selection_controller->mark_age_dirty();
         game.selection_controller->mark_selection_dirty();
@@ -260,6 +343,7 @@ std::size_t GamePopulationManager::compute_target_removal_count(std::size_t avai
 }
 
 void GamePopulationManager::remove_random_percentage(float percentage) {
+    remove_random_stored_pellets(percentage, CircleKind::Pellet, true);
     if (game.circles.empty()) {
         return;
     }
@@ -295,6 +379,9 @@ std::vector<std::size_t> GamePopulationManager::collect_pellet_indices(bool toxi
 }
 
 void GamePopulationManager::remove_percentage_pellets(float percentage, bool toxic, bool division_pellet) {
+    remove_random_stored_pellets(percentage,
+                                 division_pellet ? CircleKind::DivisionPellet : toxic ? CircleKind::ToxicPellet : CircleKind::Pellet,
+                                 false);
     if (game.circles.empty()) {
         return;
     }
@@ -431,6 +518,6 @@ void GamePopulationManager::remove_stopped_boost_particles() {
                 return should_remove;
             }),
         game.circles.end());
-    game.selection.handle_selection_after_removal(snapshot, false, nullptr, snapshot.position);
+    game.selection.handle_selection_after_removal(snapshot, false, CircleId{}, snapshot.position);
     game.selection_controller->refresh_generation_and_age();
 }
@@ -19,9 +19,13 @@ void handle_sensor_begin_touch(const b2SensorBeginTouchEvent& beginTouch, Game&
     if (auto* sensor = circle_from_shape(beginTouch.sensorShapeId)) {
         if (auto* visitor = circle_from_shape(beginTouch.visitorShapeId)) {
             if (sensor != visitor) {
-                sensor->add_touching_circle(visitor);
-                visitor->add_touching_circle(sensor);
                 game.get_contact_graph().add_contact(sensor->get_id(), visitor->get_id());
+                // Sensor overlaps never wake bodies on their own; a creature reaching a settled pellet does.
+                if (sensor->get_kind() == CircleKind::Creature) {
+                    visitor->wake();
+                } else if (visitor->get_kind() == CircleKind::Creature) {
+                    sensor->wake();
+                }
             }
         }
     }
@@ -34,15 +38,13 @@ void handle_sensor_end_touch(const b2SensorEndTouchEvent& endTouch, Game& game)
     if (auto* sensor = circle_from_shape(endTouch.sensorShapeId)) {
         if (auto* visitor = circle_from_shape(endTouch.visitorShapeId)) {
             if (sensor != visitor) {
-                sensor->remove_touching_circle(visitor);
-                visitor->remove_touching_circle(sensor);
                 game.get_contact_graph().remove_contact(sensor->get_id(), visitor->get_id());
             }
         }
     }
 }
 
-void process_touch_events(const b2WorldId& worldId, Game& game) {
+std::size_t process_touch_events(const b2WorldId& worldId, Game& game) {
     b2SensorEvents sensorEvents = b2World_GetSensorEvents(worldId);
     for (int i = 0; i < sensorEvents.beginCount; ++i)
     {
@@ -54,7 +56,42 @@ void process_touch_events(const b2WorldId& worldId, Game& game) {
     {
         b2SensorEndTouchEvent* endTouch = sensorEvents.endEvents + i;
         handle_sensor_end_touch(*endTouch, game);
+    }
+    return static_cast<std::size_t>(sensorEvents.beginCount) + static_cast<std::size_t>(sensorEvents.endCount);
+}
+
+struct MotionSummary {
+    std::size_t moved = 0;
+    float max_speed_over_radius = 0.0f;
+};
+
+// Speed / radius of a circle for the substep bound. Boost particles are ejected fast but are tiny, short-lived
+// and never interact beyond overlap tests, so they would set the step for the whole dish without needing it.
+float speed_over_radius(const CirclePhysics& circle, const b2Vec2& velocity) {
+    const float radius = circle.getRadius();
+    if (circle.get_kind() == CircleKind::BoostParticle || radius <= 0.0f) {
+        return 0.0f;
+    }
+    return b2Length(velocity) / radius;
 }
+
+// Copies the transforms of bodies that moved this step into the cache; bodies that did not move keep theirs.
+// Move events carry no velocity, so it is read once here per moved body rather than on every access.
+MotionSummary sync_body_transforms(const b2WorldId& worldId, BodyTransformCache& cache) {
+    const b2BodyEvents bodyEvents = b2World_GetBodyEvents(worldId);
+    MotionSummary summary;
+    summary.moved = static_cast<std::size_t>(bodyEvents.moveCount);
+    for (int i = 0; i < bodyEvents.moveCount; ++i) {
+        const b2BodyMoveEvent& move = bodyEvents.moveEvents[i];
+        const auto* circle = static_cast<const CirclePhysics*>(move.userData);
+        if (!circle || circle->get_id().value == 0) {
+            continue;
+        }
+        const b2Vec2 velocity = move.fellAsleep ? b2Vec2{0.0f, 0.0f} : b2Body_GetLinearVelocity(move.bodyId);
+        cache.store(circle->get_id(), move.transform.p, move.transform.q, velocity);
+        summary.max_speed_over_radius = std::max(summary.max_speed_over_radius, speed_over_radius(*circle, velocity));
+    }
+    return summary;
 }
 } // namespace
 
@@ -90,28 +127,107 @@ void GameSimulationController::process_game_logic_with_speed() {
     update_actual_sim_speed();
 }
 
+// All shapes are sensors, so Box2D never resolves overlaps and substeps only refine the integration of motion
+// and damping. What needs bounding is how far a body moves per substep relative to its own size; in a dish of
+// slow, damped circles one substep is enough. The measurement covers the bodies that moved in the previous
+// step and the bodies whose impulses were flushed since, so a boost is accounted for in the step it starts.
+GameSimulationController::PhysicsStep GameSimulationController::choose_physics_step() const {
+    const auto& physics = game.physics;
+    if (physics.quality == Game::PhysicsQuality::Fixed) {
+        return {1.0f / 60.0f, 4};
+    }
+    const float travel = std::max(physics.max_travel_fraction, 1e-3f);
+    const float rate = physics.max_speed_over_radius;
+    float dt = 1.0f / 60.0f;
+    if (physics.quality == Game::PhysicsQuality::AdaptiveStep) {
+        const float widest = rate > 0.0f ? travel * static_cast<float>(physics.max_substeps) / rate : physics.max_step;
+        dt = std::clamp(widest, physics.min_step, physics.max_step);
+    }
+    const int needed = static_cast<int>(std::ceil(rate * dt / travel));
+    return {dt, std::clamp(needed, physics.min_substeps, physics.max_substeps)};
+}
+
 void GameSimulationController::process_game_logic() {
-    float timeStep = (1.0f / 60.0f);
-    int subStepCount = 4;
+    // Raises the speed bound with the post-impulse velocity of each body a flush touched.
+    auto fold_impulse_speed = [this](b2BodyId body) {
+        const auto* circle = static_cast<const CirclePhysics*>(b2Body_GetUserData(body));
+        if (circle) {
+            game.physics.max_speed_over_radius = std::max(game.physics.max_speed_over_radius,
+                                                          speed_over_radius(*circle, b2Body_GetLinearVelocity(body)));
+        }
+    };
+    // Radius changes from the previous tick (eating, boosting, division, brain cost) reach Box2D here, once
+    // per body, so the step sees the final shapes.
+    game.profiler.shape_resizes_last_tick = game.shape_resizes.flush(game.circle_registry);
+    game.profiler.resize_requests_last_tick = game.shape_resizes.requests_last_flush();
+    // Catches impulses recorded outside the act phase, e.g. by circles spawned from the UI.
+    game.profiler.impulse_commands_last_tick = game.impulses.flush(fold_impulse_speed);
+    const PhysicsStep step = choose_physics_step();
+    const float timeStep = step.dt;
+    const int subStepCount = step.substeps;
     b2World_Step(game.worldId, timeStep, subStepCount);
     game.timing.sim_time_accum += timeStep;
     game.brain.time_accumulator += timeStep;
 
-    process_touch_events(game.worldId, game);
+    const b2Profile profile = b2World_GetProfile(game.worldId);
+    game.profiler.physics_step_ms_last_tick = profile.step;
+    game.profiler.physics_sensors_ms_last_tick = profile.sensors;
+    const int awake_bodies = b2World_GetAwakeBodyCount(game.worldId);
+    const int total_bodies = b2World_GetCounters(game.worldId).bodyCount;
+    game.profiler.awake_bodies = static_cast<std::size_t>(std::max(awake_bodies, 0));
+    game.profiler.sleeping_bodies = static_cast<std::size_t>(std::max(total_bodies - awake_bodies, 0));
+
+    const MotionSummary motion = sync_body_transforms(game.worldId, game.body_transforms);
+    game.profiler.moved_bodies_last_tick = motion.moved;
+    game.physics.max_speed_over_radius = motion.max_speed_over_radius;
+    game.profiler.physics_substeps_last_tick = subStepCount;
+    game.profiler.physics_dt_last_tick = timeStep;
+    game.profiler.sensor_events_last_tick = process_touch_events(game.worldId, game);
+    game.profiler.contact_graph_pairs = game.contact_graph.contact_count();
+    // Eating and sensing both read pair geometry from this snapshot of the step's contacts.
+    game.contact_geometry.rebuild(game.contact_graph, game.circle_registry);
+    game.profiler.contact_pairs_last_tick = game.contact_geometry.pair_count();
+    rebuild_spatial_grid();
+    apply_species_assignments();
 
     game.spawner.sprinkle_entities(timeStep);
     update_creatures(game.worldId, timeStep);
     run_brain_updates(game.worldId, timeStep);
+    // Boosts and turns of registered circles from eating and the act phase, applied in one pass before
+    // cleanup reads velocities. New boost particles and division children were launched on creation.
+    game.profiler.impulse_commands_last_tick += game.impulses.flush(fold_impulse_speed);
+    game.profiler.fastest_speed_over_radius = game.physics.max_speed_over_radius;
     game.sim_cleanup_population(timeStep);
     game.sim_remove_outside_if_enabled();
     game.sim_update_selection_after_step();
 }
 
+void GameSimulationController::rebuild_spatial_grid() {
+    std::vector<SpatialGrid::Item> items;
+    items.reserve(game.circles.size());
+    for (const auto& circle : game.circles) {
+        if (circle) {
+            items.push_back({circle->get_id(), circle->getPosition(), circle->getRadius(), circle->get_kind()});
+        }
+    }
+    game.spatial_grid.rebuild(std::move(items));
+}
+
+void GameSimulationController::apply_species_assignments() {
+    for (const auto& assignment : game.speciation.drainAssignments()) {
+        // Creatures removed while their genome was queued simply no longer resolve.
+        auto* physics = game.circle_registry.get_physics(CircleId{static_cast<uint32_t>(assignment.token)});
+        if (physics && physics->get_kind() == CircleKind::Creature) {
+            static_cast<CreatureCircle*>(physics)->set_species_id(assignment.speciesId);
+        }
+    }
+}
+
 void GameSimulationController::update_creatures(const b2WorldId&, float dt) {
     for (size_t i = 0; i < game.circles.size(); ++i) {
         if (game.circles[i] && game.circles[i]->get_kind() == CircleKind::Creature) {
             auto* creature_circle = static_cast<CreatureCircle*>(game.circles[i].get());
-            creature_circle->set_contact_context(game.contact_graph, game.circle_registry, game.dish.radius);
+            creature_circle->set_contact_context(game.contact_graph, game.circle_registry, game.contact_geometry, game.spatial_grid, game.pellet_store, game.dish.radius);
             CreatureCircle::BehaviorContext behavior_ctx{};
             behavior_ctx.boost_area = game.creature.boost_area;
             behavior_ctx.circle_density = game.movement.circle_density;
@@ -155,6 +271,7 @@ void GameSimulationController::update_creatures(const b2WorldId&, float dt) {
             division_ctx.disable_connection_thresh = game.mutation.disable_connection_thresh;
             division_ctx.add_node_thresh = game.mutation.add_node_thresh;
             division_ctx.max_iterations_find_node = game.mutation.max_iterations_find_node_thresh;
+            division_ctx.mating_probability = game.mutation.mating_probability;
             division_ctx.sim_time = game.timing.sim_time_accum;
             creature_circle->set_division_context(division_ctx);
             creature_circle->process_eating(game.worldId, game, game.death.poison_death_probability, game.death.poison_death_probability_normal);
@@ -167,12 +284,20 @@ void GameSimulationController::run_brain_updates(const b2WorldId& worldId, float
     (void)timeStep;
     const float brain_period = (game.brain.updates_per_second > 0.0f) ? (1.0f / game.brain.updates_per_second) : std::numeric_limits<float>::max();
     while (game.brain.time_accumulator >= brain_period) {
+        game.profiler.brain_evaluations_last_tick = 0;
+        game.profiler.brain_cache_hits_last_tick = 0;
+        game.profiler.brain_flops_executed_last_tick = 0;
+        game.profiler.brain_flops_nominal_last_tick = 0;
+        game.profiler.brain_connections_last_tick = 0;
+        game.profiler.brain_hidden_nodes_last_tick = 0;
+        game.profiler.brain_metabolic_area_last_tick = 0.0f;
+        game.profiler.vision_candidates_last_tick = 0;
         for (size_t i = 0; i < game.circles.size(); ++i) {
             if (game.circles[i] && game.circles[i]->get_kind() == CircleKind::Creature) {
                 auto* creature_circle = static_cast<CreatureCircle*>(game.circles[i].get());
                 creature_circle->set_minimum_area(game.creature.minimum_area);
                 creature_circle->set_display_mode(!game.show_true_color);
-                creature_circle->set_contact_context(game.contact_graph, game.circle_registry, game.dish.radius);
+                creature_circle->set_contact_context(game.contact_graph, game.circle_registry, game.contact_geometry, game.spatial_grid, game.pellet_store, game.dish.radius);
                 CreatureCircle::BehaviorContext behavior_ctx{};
                 behavior_ctx.boost_area = game.creature.boost_area;
                 behavior_ctx.circle_density = game.movement.circle_density;
@@ -195,6 +320,13 @@ void GameSimulationController::run_brain_updates(const b2WorldId& worldId, float
             behavior_ctx.left_key_down = game.possesing.left_key_down;
             behavior_ctx.right_key_down = game.possesing.right_key_down;
             behavior_ctx.space_key_down = game.possesing.space_key_down;
+            behavior_ctx.brain_cache_enabled = game.brain.eval_cache_enabled;
+            behavior_ctx.brain_cache_epsilon = game.brain.eval_cache_epsilon;
+            behavior_ctx.brain_cost_per_connection = game.brain.cost_per_connection;
+            behavior_ctx.brain_cost_per_node = game.brain.cost_per_node;
+            behavior_ctx.sensor_mode = game.brain.sensor_mode;
+            behavior_ctx.vision_radius = game.brain.vision_radius;
+            behavior_ctx.vision_summary = game.brain.vision_summary;
             behavior_ctx.spawn_circle = [&](std::unique_ptr<EatableCircle> c) { game.population_mgr().add_circle(std::move(c)); };
                 creature_circle->set_behavior_context(behavior_ctx);
                 CreatureCircle::DivisionContext division_ctx{};
@@ -216,11 +348,26 @@ void GameSimulationController::run_brain_updates(const b2WorldId& worldId, float
             division_ctx.disable_connection_thresh = game.mutation.disable_connection_thresh;
             division_ctx.add_node_thresh = game.mutation.add_node_thresh;
             division_ctx.max_iterations_find_node = game.mutation.max_iterations_find_node_thresh;
+            division_ctx.mating_probability = game.mutation.mating_probability;
             division_ctx.sim_time = game.timing.sim_time_accum;
             creature_circle->set_division_context(division_ctx);
             creature_circle->move_intelligently(worldId, game, brain_period);
+            ++game.profiler.brain_evaluations_last_tick;
+            const auto flops = static_cast<std::size_t>(creature_circle->brain_flops_per_eval());
+            game.profiler.brain_flops_nominal_last_tick += flops;
+            if (creature_circle->last_brain_eval_was_cached()) {
+                ++game.profiler.brain_cache_hits_last_tick;
+            } else {
+                game.profiler.brain_flops_executed_last_tick += flops;
+            }
+            game.profiler.brain_connections_last_tick += static_cast<std::size_t>(creature_circle->get_brain_enabled_connections());
+            game.profiler.brain_hidden_nodes_last_tick += static_cast<std::size_t>(creature_circle->get_brain_enabled_hidden_nodes());
+            game.profiler.brain_metabolic_area_last_tick += creature_circle->get_last_brain_metabolic_cost();
+            game.profiler.vision_candidates_last_tick += static_cast<std::size_t>(creature_circle->get_last_vision_candidates());
             }
         }
+        game.profiler.brain_evaluations_total += game.profiler.brain_evaluations_last_tick;
+        game.profiler.brain_cache_hits_total += game.profiler.brain_cache_hits_last_tick;
         game.brain.time_accumulator -= brain_period;
     }
 }
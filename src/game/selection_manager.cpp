@@ -5,52 +5,52 @@
 #include <limits>
 
 #include "creatures/creature_circle.hpp"
+#include "circles/circle_registry.hpp"
 #include "circles/eatable_circle.hpp"
+#include "circles/spatial_grid.hpp"
 
-SelectionManager::SelectionManager(std::vector<std::unique_ptr<EatableCircle>>& circles, float& sim_time_accum)
-    : circles(&circles), sim_time(&sim_time_accum) {}
+SelectionManager::SelectionManager(std::vector<std::unique_ptr<EatableCircle>>& circles,
+                                   float& sim_time_accum,
+                                   const SpatialGrid& grid,
+                                   const CircleRegistry& registry)
+    : circles(&circles), sim_time(&sim_time_accum), grid(&grid), registry(&registry) {}
 
 void SelectionManager::clear() {
-    selected_index.reset();
+    selected = CircleId{};
 }
 
 bool SelectionManager::select_circle_at_world(const b2Vec2& pos) {
     if (!circles) return false;
-    std::optional<std::size_t> hit;
+    const EatableCircle* hit = nullptr;
     float best_dist2 = std::numeric_limits<float>::max();
-    for (std::size_t i = 0; i < circles->size(); ++i) {
-        const auto& c = (*circles)[i];
-        b2Vec2 p = c->getPosition();
-        float dx = p.x - pos.x;
-        float dy = p.y - pos.y;
+    grid->for_each_in_radius(pos, 0.0f, [&](const SpatialGrid::Item& item) {
+        const auto* circle = registry->get_eatable(item.id);
+        if (!circle) return;
+        float dx = item.position.x - pos.x;
+        float dy = item.position.y - pos.y;
         float dist2 = dx * dx + dy * dy;
-        float r = c->getRadius();
-        if (dist2 <= r * r && dist2 < best_dist2) {
-            hit = i;
+        if (dist2 < best_dist2) {
+            hit = circle;
             best_dist2 = dist2;
         }
-    }
-    selected_index = hit;
-    return selected_index.has_value();
+    });
+    selected = hit ? hit->get_id() : CircleId{};
+    return hit != nullptr;
+}
+
+const EatableCircle* SelectionManager::resolve_selected() const {
+    return registry->get_eatable(selected);
 }
 
 const neat::Genome* SelectionManager::get_selected_brain() const {
-    if (!circles || !selected_index || *selected_index >= circles->size()) {
-        return nullptr;
-    }
-    const auto* base = (*circles)[*selected_index].get();
-    if (base && base->get_kind() == CircleKind::Creature) {
-        const auto* creature = static_cast<const CreatureCircle*>(base);
+    if (const CreatureCircle* creature = get_selected_creature()) {
         return &creature->get_brain();
     }
     return nullptr;
 }
 
 const CreatureCircle* SelectionManager::get_selected_creature() const {
-    if (!circles || !selected_index || *selected_index >= circles->size()) {
-        return nullptr;
-    }
-    const auto* base = (*circles)[*selected_index].get();
+    const auto* base = resolve_selected();
     if (base && base->get_kind() == CircleKind::Creature) {
         return static_cast<const CreatureCircle*>(base);
     }
@@ -132,12 +132,8 @@ const CreatureCircle* SelectionManager::get_follow_target_creature() const {
 }
 
 int SelectionManager::get_selected_generation() const {
-    if (!circles || !selected_index || *selected_index >= circles->size()) {
-        return -1;
-    }
-    const auto* base = (*circles)[*selected_index].get();
-    if (base && base->get_kind() == CircleKind::Creature) {
-        return static_cast<const CreatureCircle*>(base)->get_generation();
+    if (const CreatureCircle* creature = get_selected_creature()) {
+        return creature->get_generation();
     }
     return -1;
 }
@@ -159,82 +155,50 @@ bool SelectionManager::get_follow_selected() const {
 
 SelectionManager::Snapshot SelectionManager::capture_snapshot() const {
     Snapshot snapshot{};
-    if (selected_index && circles && *selected_index < circles->size()) {
-        snapshot.circle = (*circles)[*selected_index].get();
-        snapshot.position = snapshot.circle->getPosition();
+    if (const auto* circle = resolve_selected()) {
+        snapshot.id = selected;
+        snapshot.position = circle->getPosition();
     }
     return snapshot;
 }
 
-void SelectionManager::revalidate_selection(const EatableCircle* previously_selected) {
-    if (!circles || !previously_selected) {
-        return;
-    }
-    selected_index.reset();
-    for (std::size_t i = 0; i < circles->size(); ++i) {
-        if ((*circles)[i].get() == previously_selected) {
-            selected_index = i;
-            break;
-        }
+void SelectionManager::revalidate_selection() {
+    if (!registry->contains(selected)) {
+        selected = CircleId{};
     }
 }
 
 void SelectionManager::set_selection_to_creature(const CreatureCircle* creature) {
-    if (!circles) return;
-    if (!creature) {
-        selected_index.reset();
-        return;
-    }
-    for (std::size_t i = 0; i < circles->size(); ++i) {
-        if ((*circles)[i].get() == creature) {
-            selected_index = i;
-            return;
-        }
-    }
-    selected_index.reset();
+    selected = creature ? creature->get_id() : CircleId{};
 }
 
+void SelectionManager::set_selection_to_creature(CircleId creature) {
+    const auto* physics = registry->get_physics(creature);
+    selected = physics && physics->get_kind() == CircleKind::Creature ? creature : CircleId{};
+}
+
+// Nearest by the grid's positions from the last physics step.
 const CreatureCircle* SelectionManager::find_nearest_creature(const b2Vec2& pos) const {
     if (!circles) return nullptr;
-    const CreatureCircle* best = nullptr;
-    float best_dist2 = std::numeric_limits<float>::max();
-    for (const auto& c : *circles) {
-        if (c && c->get_kind() == CircleKind::Creature) {
-            auto* creature = static_cast<const CreatureCircle*>(c.get());
-            b2Vec2 p = creature->getPosition();
-            float dx = p.x - pos.x;
-            float dy = p.y - pos.y;
-            float d2 = dx * dx + dy * dy;
-            if (d2 < best_dist2) {
-                best_dist2 = d2;
-                best = creature;
-            }
-        }
-    }
-    return best;
+    const auto nearest = grid->k_nearest(pos, 1, [&](const SpatialGrid::Item& item) {
+        return item.kind == CircleKind::Creature && registry->get_physics(item.id) != nullptr;
+    });
+    if (nearest.empty()) return nullptr;
+    return static_cast<const CreatureCircle*>(registry->get_physics(nearest.front().id));
 }
 
-void SelectionManager::handle_selection_after_removal(const Snapshot& snapshot, bool was_removed, const CreatureCircle* preferred_fallback, const b2Vec2& fallback_position) {
+void SelectionManager::handle_selection_after_removal(const Snapshot& snapshot, bool was_removed, CircleId preferred_fallback, const b2Vec2& fallback_position) {
     if (was_removed) {
         if (follow_selected) {
-            const CreatureCircle* fallback = nullptr;
-            if (preferred_fallback && circles) {
-                const bool still_exists = std::any_of(
-                    circles->begin(),
-                    circles->end(),
-                    [&](const std::unique_ptr<EatableCircle>& c) { return c.get() == preferred_fallback; });
-                if (still_exists) {
-                    fallback = preferred_fallback;
-                }
-            }
-            if (!fallback) {
-                fallback = find_nearest_creature(fallback_position);
+            // The killer may have been removed in the same pass; its id then no longer resolves.
+            set_selection_to_creature(preferred_fallback);
+            if (!registry->contains(selected)) {
+                set_selection_to_creature(find_nearest_creature(fallback_position));
             }
-            set_selection_to_creature(fallback);
         } else {
-            selected_index.reset();
+            selected = CircleId{};
         }
-    } else if (snapshot.circle) {
-        revalidate_selection(snapshot.circle);
+    } else if (snapshot.id != CircleId{}) {
+        revalidate_selection();
     }
 }
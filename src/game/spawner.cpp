@@ -61,7 +61,7 @@ void Spawner::spawn_selected_type_at(const sf::Vector2f& worldPos) {
             if (pellet_cap_reached(static_cast<int>(context.get_add_type()))) {
                 break;
             }
-            context.population_mgr().add_circle(create_eatable_for_add_type(*this, {worldPos.x, worldPos.y}, static_cast<SpawnAddType>(context.get_add_type())));
+            spawn_pellet({worldPos.x, worldPos.y}, static_cast<SpawnAddType>(context.get_add_type()));
             break;
         default:
             break;
@@ -103,7 +103,7 @@ void Spawner::continue_add_drag(const sf::Vector2f& worldPos) {
             case SpawnAddType::ToxicPellet:
             case SpawnAddType::DivisionPellet:
                 if (!pellet_cap_reached(static_cast<int>(context.get_add_type()))) {
-                    context.population_mgr().add_circle(create_eatable_for_add_type(*this, {worldPos.x, worldPos.y}, static_cast<SpawnAddType>(context.get_add_type())));
+                    spawn_pellet({worldPos.x, worldPos.y}, static_cast<SpawnAddType>(context.get_add_type()));
                 }
                 last_add_world_pos = worldPos;
                 break;
@@ -166,7 +166,8 @@ std::unique_ptr<CreatureCircle> Spawner::create_creature_at(const b2Vec2& pos) {
         context.get_init_add_connection_thresh(),
         base_brain,
         context.get_neat_innovations(),
-        context.get_neat_last_innovation_id());
+        context.get_neat_last_innovation_id(),
+        context.get_color_sensor_count());
     circle->set_creation_time(context.get_sim_time());
     circle->set_last_division_time(context.get_sim_time());
     circle->set_impulse_magnitudes(context.get_linear_impulse_magnitude(), context.get_angular_impulse_magnitude());
@@ -175,6 +176,18 @@ std::unique_ptr<CreatureCircle> Spawner::create_creature_at(const b2Vec2& pos) {
     return circle;
 }
 
+// Lightweight pellets skip the Box2D body entirely.
+void Spawner::spawn_pellet(const b2Vec2& pos, SpawnAddType type) {
+    if (context.get_lightweight_pellets()) {
+        const CircleKind kind = type == SpawnAddType::DivisionPellet ? CircleKind::DivisionPellet
+                                : type == SpawnAddType::ToxicPellet  ? CircleKind::ToxicPellet
+                                                                     : CircleKind::Pellet;
+        context.population_mgr().add_pellet(pos, radius_from_area(context.get_add_eatable_area()), kind);
+        return;
+    }
+    context.population_mgr().add_circle(create_eatable_for_add_type(*this, pos, type));
+}
+
 std::unique_ptr<EatableCircle> Spawner::create_eatable_at(const b2Vec2& pos, bool toxic, bool division_pellet) const {
     float radius = radius_from_area(context.get_add_eatable_area());
     auto circle = std::make_unique<EatableCircle>(context.world_id(), pos.x, pos.y, radius, context.get_circle_density(), toxic, division_pellet, 0.0f);
@@ -236,7 +249,7 @@ void Spawner::sprinkle_with_rate(float rate, int type, float dt) {
             case SpawnAddType::FoodPellet:
             case SpawnAddType::ToxicPellet:
             case SpawnAddType::DivisionPellet:
-                context.population_mgr().add_circle(create_eatable_for_add_type(*this, pos, add_type));
+                spawn_pellet(pos, add_type);
                 break;
         }
         return true;
@@ -13,15 +13,18 @@
 #include "ui/ui.hpp"
 #include "ui/ui_facade.hpp"
 
+#include <cstdlib>
+#include <cstring>
 #include <time.h>
 
 void handle_events(sf::RenderWindow& window, sf::View& view, Game& game);
+int parse_color_sensor_count(int argc, char** argv);
 
 
-int main() {
+int main(int argc, char** argv) {
     srand(time(NULL));
 
-    Game game;
+    Game game(parse_color_sensor_count(argc, argv));
     UiFacade ui(game);
 
     sf::RenderWindow window(sf::VideoMode({1280, 720}), "Petri Dish Simulation");
@@ -64,6 +67,20 @@ int main() {
     return 0;
 }
 
+// `--sensors N` picks the creature color sensor count for this dish (see config/simulation_config.hpp).
+int parse_color_sensor_count(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--sensors") == 0) {
+            const int count = std::atoi(argv[i + 1]);
+            if (is_supported_color_sensor_count(count)) {
+                return count;
+            }
+            std::cerr << "Unsupported color sensor count " << argv[i + 1] << ", using " << kColorSensorCount << "\n";
+        }
+    }
+    return kColorSensorCount;
+}
+
 void handle_events(sf::RenderWindow& window, sf::View& view, Game& game) {
     static sf::Vector2u previous_window_size = window.getSize();
     while (const auto event = window.pollEvent()) {
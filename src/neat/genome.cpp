@@ -34,6 +34,8 @@ Genome::Genome(int nbInput, int nbOutput, std::vector<std::vector<int>>* innovId
                 connections.push_back(Connection(innovId, inNodeId, outNodeId, weight, true));
             }
         }
+        // Pairs may already have innovations from other genomes, so creation order is not innovation order.
+        sortConnectionsByInnovation();
     }
     topoDirty = true;
 }
@@ -100,6 +102,26 @@ void Genome::getOutputs(float outputs[]) {
     }
 }
 
+int Genome::countEnabledConnections() const {
+    int count = 0;
+    for (const auto& conn : connections) {
+        if (conn.enabled) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int Genome::countEnabledHiddenNodes() const {
+    int count = 0;
+    for (int i = nbInput + nbOutput + 1; i < static_cast<int>(nodes.size()); i++) {
+        if (nodes[i].enabled) {
+            count++;
+        }
+    }
+    return count;
+}
+
 void Genome::mutate(std::vector<std::vector<int>>* innovIds, int* lastInnovId, float mutateWeightThresh, float mutateWeightFullChangeThresh, float mutateWeightFactor, float addConnectionThresh, int maxIterationsFindConnectionThresh, float reactivateConnectionThresh, float disableConnectionThresh, float addNodeThresh, int maxIterationsFindNodeThresh) {
     float randomNb = randomUnitExclusive();
 
@@ -180,7 +202,7 @@ bool Genome::addConnection(std::vector<std::vector<int>>* innovIds, int* lastInn
 
     int innovId = getInnovId(innovIds, lastInnovId, inNodeId, outNodeId);
     float weight = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f * weightExtremumInit - weightExtremumInit;
-    connections.push_back(Connection(innovId, inNodeId, outNodeId, weight, true));
+    insertConnectionSorted(Connection(innovId, inNodeId, outNodeId, weight, true));
     nodes[inNodeId].enabled = true;
     nodes[outNodeId].enabled = true;
     topoDirty = true;
@@ -207,25 +229,20 @@ bool Genome::disableConnection() {
 }
 
 void Genome::disableOrphanHiddenNodes() {
-    bool changed = false;
-    int hiddenStartId = nbInput + nbOutput + 1;
-    for (auto& node : nodes) {
-        if (node.id < hiddenStartId) continue;
-
-        bool hasEnabledEdge = false;
-        for (const auto& conn : connections) {
-            if (!conn.enabled) continue;
-            if (conn.inNodeId == node.id || conn.outNodeId == node.id) {
-                hasEnabledEdge = true;
-                break;
-            }
-        }
+    // One pass over the connections marks every node with an enabled edge, then one pass over the nodes.
+    std::vector<char> hasEnabledEdge(nodes.size(), 0);
+    for (const auto& conn : connections) {
+        if (!conn.enabled) continue;
+        hasEnabledEdge[conn.inNodeId] = 1;
+        hasEnabledEdge[conn.outNodeId] = 1;
+    }
 
-        if (!hasEnabledEdge && node.enabled) {
-            node.enabled = false;
-            changed = true;
-        } else if (hasEnabledEdge && !node.enabled) {
-            node.enabled = true;
+    bool changed = false;
+    const std::size_t hiddenStartId = static_cast<std::size_t>(nbInput + nbOutput + 1);
+    for (std::size_t id = hiddenStartId; id < nodes.size(); ++id) {
+        const bool enabled = hasEnabledEdge[id] != 0;
+        if (nodes[id].enabled != enabled) {
+            nodes[id].enabled = enabled;
             changed = true;
         }
     }
@@ -267,14 +284,19 @@ bool Genome::addNode(std::vector<std::vector<int>>* innovIds, int* lastInnovId,
     }
 
     connections[connId].enabled = false;
-    nodes.push_back(Node(static_cast<int>(nodes.size()), nodes[connections[connId].inNodeId].layer + 1));
+    // Copy the split connection: sorted inserts below shift indices.
+    const Connection split = connections[connId];
+    nodes.push_back(Node(static_cast<int>(nodes.size()), nodes[split.inNodeId].layer + 1));
     int newInNodeId = nodes.back().id;
 
-    int innovId = getInnovId(innovIds, lastInnovId, connections[connId].inNodeId, newInNodeId);
-    connections.push_back(Connection(innovId, connections[connId].inNodeId, newInNodeId, 1.0f, true));
+    int innovId = getInnovId(innovIds, lastInnovId, split.inNodeId, newInNodeId);
+    insertConnectionSorted(Connection(innovId, split.inNodeId, newInNodeId, 1.0f, true));
 
-    innovId = getInnovId(innovIds, lastInnovId, newInNodeId, connections[connId].outNodeId);
-    connections.push_back(Connection(innovId, newInNodeId, connections[connId].outNodeId, connections[connId].weight, true));
+    innovId = getInnovId(innovIds, lastInnovId, newInNodeId, split.outNodeId);
+    insertConnectionSorted(Connection(innovId, newInNodeId, split.outNodeId, split.weight, true));
+    // Push the split's downstream layers now: addConnection trusts layers to reject backward edges, and a
+    // stale layer here would let a later mutation close a cycle.
+    updateLayersRec(newInNodeId);
 
     topoDirty = true;
     return true;
@@ -335,6 +357,77 @@ void Genome::rebuildTopology() {
     topoDirty = false;
 }
 
+void Genome::insertConnectionSorted(const Connection& connection) {
+    auto it = std::upper_bound(connections.begin(), connections.end(), connection.innovId, [](int innovId, const Connection& conn) {
+        return innovId < conn.innovId;
+    });
+    connections.insert(it, connection);
+}
+
+void Genome::sortConnectionsByInnovation() {
+    auto byInnovation = [](const Connection& lhs, const Connection& rhs) { return lhs.innovId < rhs.innovId; };
+    if (!std::is_sorted(connections.begin(), connections.end(), byInnovation)) {
+        std::stable_sort(connections.begin(), connections.end(), byInnovation);
+        topoDirty = true;
+    }
+}
+
+GeneAlignment Genome::alignGenes(const Genome& a, const Genome& b) {
+    GeneAlignment alignment;
+    const auto& lhs = a.connections;
+    const auto& rhs = b.connections;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < lhs.size() && j < rhs.size()) {
+        if (lhs[i].innovId == rhs[j].innovId) {
+            alignment.matching++;
+            alignment.weightDifferenceSum += std::fabs(lhs[i].weight - rhs[j].weight);
+            i++;
+            j++;
+        } else if (lhs[i].innovId < rhs[j].innovId) {
+            alignment.disjoint++;
+            i++;
+        } else {
+            alignment.disjoint++;
+            j++;
+        }
+    }
+    alignment.excess = static_cast<int>((lhs.size() - i) + (rhs.size() - j));
+    return alignment;
+}
+
+Genome Genome::crossover(const Genome& a, const Genome& b, float disabledGeneThresh) {
+    const bool aIsFitter = a.fitness >= b.fitness;
+    const Genome& fitter = aIsFitter ? a : b;
+    const Genome& other = aIsFitter ? b : a;
+
+    Genome child = fitter;
+    std::size_t j = 0;
+    for (auto& gene : child.connections) {
+        while (j < other.connections.size() && other.connections[j].innovId < gene.innovId) {
+            j++;
+        }
+        if (j == other.connections.size()) {
+            break;
+        }
+        const Connection& match = other.connections[j];
+        if (match.innovId != gene.innovId) {
+            continue;
+        }
+        if (rand() % 2 == 0) {
+            gene.weight = match.weight;
+        }
+        if (gene.enabled && !match.enabled && randomUnitExclusive() < disabledGeneThresh) {
+            gene.enabled = false;
+        }
+    }
+
+    child.fitness = 0.0f;
+    child.disableOrphanHiddenNodes();
+    child.topoDirty = true;
+    return child;
+}
+
 void Genome::drawNetwork() {
     // Disabled to avoid SFML dependency in this project build.
 }
@@ -0,0 +1,141 @@
+#include <neat/genome_corpus.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+
+namespace neat {
+
+namespace {
+constexpr const char* kCorpusHeader = "# neat genome corpus v1";
+constexpr std::size_t kMinNodeRecordBytes = 8;
+constexpr std::size_t kMinConnectionRecordBytes = 12;
+} // namespace
+
+bool saveGenomeCorpus(const std::string& path, const std::vector<const Genome*>& genomes) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << kCorpusHeader << '\n';
+    out << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (const Genome* genome : genomes) {
+        if (!genome) continue;
+        out << "genome " << genome->nbInput << ' ' << genome->nbOutput << ' ' << genome->getWeightExtremumInit() << ' '
+            << genome->nodes.size() << ' ' << genome->connections.size() << '\n';
+        for (const auto& node : genome->nodes) {
+            out << "n " << node.id << ' ' << node.layer << ' ' << (node.enabled ? 1 : 0) << '\n';
+        }
+        for (const auto& conn : genome->connections) {
+            out << "c " << conn.innovId << ' ' << conn.inNodeId << ' ' << conn.outNodeId << ' ' << conn.weight << ' '
+                << (conn.enabled ? 1 : 0) << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+std::vector<Genome> loadGenomeCorpus(const std::string& path, std::string* error) {
+    std::vector<Genome> genomes;
+    auto fail = [&](const std::string& message) {
+        if (error) {
+            *error = path + ": genome " + std::to_string(genomes.size()) + ": " + message;
+        }
+        return std::vector<Genome>{};
+    };
+    std::ifstream in(path);
+    if (!in) {
+        if (error) {
+            *error = path + ": cannot open";
+        }
+        return genomes;
+    }
+    in.seekg(0, std::ios::end);
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    std::vector<std::vector<int>> scratchInnovIds;
+    int scratchLastInnovId = 0;
+    std::string tag;
+    while (in >> tag) {
+        if (tag[0] == '#') {
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
+        if (tag != "genome") {
+            return fail("expected 'genome', found '" + tag + "'");
+        }
+        int nbInput = 0;
+        int nbOutput = 0;
+        float weightExtremumInit = 0.0f;
+        std::size_t nodeCount = 0;
+        std::size_t connectionCount = 0;
+        if (!(in >> nbInput >> nbOutput >> weightExtremumInit >> nodeCount >> connectionCount)) {
+            return fail("malformed header");
+        }
+        // Every record takes at least "n 0 0 0\n" or "c 0 0 0 0 0\n", so the counts cannot exceed what the
+        // rest of the file holds; checking first keeps a corrupt header from driving the resizes below.
+        const std::streamoff here = in.tellg();
+        const std::size_t remaining = here >= 0 && here < fileSize ? static_cast<std::size_t>(fileSize - here) : 0;
+        if (nodeCount > remaining / kMinNodeRecordBytes ||
+            connectionCount > (remaining - nodeCount * kMinNodeRecordBytes) / kMinConnectionRecordBytes) {
+            return fail("node/connection counts exceed the file size");
+        }
+        if (nbInput < 0 || nbOutput < 0 || static_cast<std::size_t>(nbInput) + static_cast<std::size_t>(nbOutput) + 1 > nodeCount) {
+            return fail("input/output counts do not fit the node count");
+        }
+
+        Genome genome(nbInput, nbOutput, &scratchInnovIds, &scratchLastInnovId, weightExtremumInit, false);
+        genome.nodes.resize(nodeCount);
+        genome.connections.resize(connectionCount);
+        for (auto& node : genome.nodes) {
+            int enabled = 0;
+            if (!(in >> tag >> node.id >> node.layer >> enabled) || tag != "n") {
+                return fail("malformed node record");
+            }
+            node.enabled = enabled != 0;
+        }
+        for (auto& conn : genome.connections) {
+            int enabled = 0;
+            if (!(in >> tag >> conn.innovId >> conn.inNodeId >> conn.outNodeId >> conn.weight >> enabled) || tag != "c") {
+                return fail("malformed connection record");
+            }
+            conn.enabled = enabled != 0;
+        }
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            if (genome.nodes[i].id != static_cast<int>(i)) {
+                return fail("node ids are not 0.." + std::to_string(nodeCount - 1) + " in order");
+            }
+        }
+        for (const auto& conn : genome.connections) {
+            if (conn.inNodeId < 0 || conn.outNodeId < 0 ||
+                conn.inNodeId >= static_cast<int>(nodeCount) || conn.outNodeId >= static_cast<int>(nodeCount)) {
+                return fail("connection " + std::to_string(conn.innovId) + " references a missing node");
+            }
+        }
+        genome.nodes[0].sumInput = 1.0f;
+        genome.nodes[0].sumOutput = 1.0f;
+        genome.sortConnectionsByInnovation();
+        genomes.push_back(std::move(genome));
+    }
+    return genomes;
+}
+
+void seedInnovations(const std::vector<Genome>& genomes, std::vector<std::vector<int>>* innovIds, int* lastInnovId) {
+    for (const auto& genome : genomes) {
+        for (const auto& conn : genome.connections) {
+            if (static_cast<int>(innovIds->size()) < conn.inNodeId + 1) {
+                innovIds->resize(conn.inNodeId + 1);
+            }
+            auto& row = (*innovIds)[conn.inNodeId];
+            if (static_cast<int>(row.size()) < conn.outNodeId + 1) {
+                row.resize(conn.outNodeId + 1, -1);
+            }
+            row[conn.outNodeId] = conn.innovId;
+            *lastInnovId = std::max(*lastInnovId, conn.innovId);
+        }
+    }
+}
+
+} // namespace neat
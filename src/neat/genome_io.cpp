@@ -0,0 +1,346 @@
+#include <neat/genome_io.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace neat {
+
+// Records are read in place, so the host byte order has to match the on-disk one.
+static_assert(std::endian::native == std::endian::little, "genome archives require a little-endian host");
+
+namespace {
+constexpr char kArchiveMagic[8] = {'N', 'E', 'A', 'T', 'G', 'E', 'N', '\0'};
+constexpr std::size_t kSectionAlignment = 8;
+
+std::size_t alignSection(std::size_t offset) {
+    return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+std::size_t genomeRecordSize(std::size_t nodeCount, std::size_t connectionCount) {
+    std::size_t size = sizeof(GenomeRecordHeader);
+    size = alignSection(size + nodeCount * sizeof(NodeRecord));
+    size = alignSection(size + connectionCount * sizeof(ConnectionRecord));
+    return size;
+}
+
+template <typename T>
+const T* recordAt(const std::byte* data, std::size_t offset) {
+    return reinterpret_cast<const T*>(data + offset);
+}
+
+template <typename T>
+void storeAt(std::vector<std::byte>& buffer, std::size_t offset, const T& value) {
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+std::vector<InnovationRecord> collectInnovations(const std::vector<std::vector<int>>* innovIds) {
+    std::vector<InnovationRecord> records;
+    if (!innovIds) {
+        return records;
+    }
+    for (std::size_t inNodeId = 0; inNodeId < innovIds->size(); ++inNodeId) {
+        const auto& row = (*innovIds)[inNodeId];
+        for (std::size_t outNodeId = 0; outNodeId < row.size(); ++outNodeId) {
+            if (row[outNodeId] != -1) {
+                records.push_back({static_cast<std::int32_t>(inNodeId), static_cast<std::int32_t>(outNodeId), row[outNodeId]});
+            }
+        }
+    }
+    return records;
+}
+
+bool genomeRecordIsValid(const std::byte* data, std::size_t size, std::uint64_t offset) {
+    if (offset % kSectionAlignment != 0 || offset > size || size - offset < sizeof(GenomeRecordHeader)) {
+        return false;
+    }
+    const auto* header = recordAt<GenomeRecordHeader>(data, offset);
+    if (header->nbInput < 0 || header->nbOutput < 0 ||
+        header->nodeCount < static_cast<std::uint64_t>(header->nbInput) + static_cast<std::uint64_t>(header->nbOutput) + 1) {
+        return false;
+    }
+    if (size - offset < genomeRecordSize(header->nodeCount, header->connectionCount)) {
+        return false;
+    }
+
+    // Layers index Genome::rebuildTopology's per-layer table, and enabled connections must point strictly
+    // forward; otherwise the layer propagation in Genome never terminates.
+    const auto nodeCount = static_cast<std::int32_t>(header->nodeCount);
+    const auto* nodes = recordAt<NodeRecord>(data, offset + sizeof(GenomeRecordHeader));
+    for (std::uint32_t i = 0; i < header->nodeCount; ++i) {
+        if (nodes[i].id != static_cast<std::int32_t>(i) || nodes[i].layer < 0 || nodes[i].layer >= nodeCount) {
+            return false;
+        }
+    }
+    const std::size_t connectionOffset = alignSection(offset + sizeof(GenomeRecordHeader) + header->nodeCount * sizeof(NodeRecord));
+    const auto* connections = recordAt<ConnectionRecord>(data, connectionOffset);
+    for (std::uint32_t i = 0; i < header->connectionCount; ++i) {
+        const auto& conn = connections[i];
+        if (conn.inNodeId < 0 || conn.outNodeId < 0 || conn.inNodeId >= nodeCount || conn.outNodeId >= nodeCount) {
+            return false;
+        }
+        if (conn.enabled != 0 && nodes[conn.inNodeId].layer >= nodes[conn.outNodeId].layer) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+Genome GenomeView::toGenome() const {
+    std::vector<std::vector<int>> scratchInnovIds;
+    int scratchLastInnovId = 0;
+    Genome genome(header->nbInput, header->nbOutput, &scratchInnovIds, &scratchLastInnovId, header->weightExtremumInit, false);
+    genome.fitness = header->fitness;
+    genome.speciesId = header->speciesId;
+
+    genome.nodes.resize(header->nodeCount);
+    for (std::size_t i = 0; i < genome.nodes.size(); ++i) {
+        Node& node = genome.nodes[i];
+        node.id = nodeTable[i].id;
+        node.layer = nodeTable[i].layer;
+        node.enabled = nodeTable[i].enabled != 0;
+    }
+    genome.nodes[0].sumInput = 1.0f;
+    genome.nodes[0].sumOutput = 1.0f;
+
+    genome.connections.reserve(header->connectionCount);
+    for (std::size_t i = 0; i < header->connectionCount; ++i) {
+        const ConnectionRecord& record = connectionTable[i];
+        genome.connections.push_back(Connection(record.innovId, record.inNodeId, record.outNodeId, record.weight, record.enabled != 0));
+    }
+    genome.sortConnectionsByInnovation();
+    return genome;
+}
+
+std::optional<GenomeArchiveView> GenomeArchiveView::open(const std::byte* data, std::size_t size) {
+    if (!data || size < sizeof(GenomeFileHeader) || reinterpret_cast<std::uintptr_t>(data) % kSectionAlignment != 0) {
+        return std::nullopt;
+    }
+    const auto* header = recordAt<GenomeFileHeader>(data, 0);
+    if (std::memcmp(header->magic, kArchiveMagic, sizeof(kArchiveMagic)) != 0 ||
+        header->version != kGenomeArchiveVersion ||
+        header->headerSize < sizeof(GenomeFileHeader) ||
+        header->fileSize > size) {
+        return std::nullopt;
+    }
+    size = static_cast<std::size_t>(header->fileSize);
+
+    const std::uint64_t innovationBytes = static_cast<std::uint64_t>(header->innovationCount) * sizeof(InnovationRecord);
+    if (header->innovationOffset % kSectionAlignment != 0 || header->innovationOffset > size ||
+        size - header->innovationOffset < innovationBytes) {
+        return std::nullopt;
+    }
+    const std::uint64_t indexBytes = static_cast<std::uint64_t>(header->genomeCount) * sizeof(std::uint64_t);
+    if (header->genomeIndexOffset % kSectionAlignment != 0 || header->genomeIndexOffset > size ||
+        size - header->genomeIndexOffset < indexBytes) {
+        return std::nullopt;
+    }
+
+    const auto* offsets = recordAt<std::uint64_t>(data, static_cast<std::size_t>(header->genomeIndexOffset));
+    for (std::uint32_t i = 0; i < header->genomeCount; ++i) {
+        if (!genomeRecordIsValid(data, size, offsets[i])) {
+            return std::nullopt;
+        }
+    }
+    return GenomeArchiveView(data, header);
+}
+
+GenomeView GenomeArchiveView::operator[](std::size_t index) const {
+    const auto* offsets = recordAt<std::uint64_t>(data, static_cast<std::size_t>(header->genomeIndexOffset));
+    const auto offset = static_cast<std::size_t>(offsets[index]);
+    const auto* record = recordAt<GenomeRecordHeader>(data, offset);
+    const std::size_t nodeOffset = offset + sizeof(GenomeRecordHeader);
+    const std::size_t connectionOffset = alignSection(nodeOffset + record->nodeCount * sizeof(NodeRecord));
+    return GenomeView(record, recordAt<NodeRecord>(data, nodeOffset), recordAt<ConnectionRecord>(data, connectionOffset));
+}
+
+const InnovationRecord* GenomeArchiveView::innovations() const {
+    return recordAt<InnovationRecord>(data, static_cast<std::size_t>(header->innovationOffset));
+}
+
+std::vector<Genome> GenomeArchiveView::toGenomes() const {
+    std::vector<Genome> genomes;
+    genomes.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        genomes.push_back((*this)[i].toGenome());
+    }
+    return genomes;
+}
+
+void GenomeArchiveView::seedInnovations(std::vector<std::vector<int>>* innovIds, int* lastInnovId) const {
+    const InnovationRecord* records = innovations();
+    for (std::size_t i = 0; i < innovationCount(); ++i) {
+        const InnovationRecord& record = records[i];
+        if (record.inNodeId < 0 || record.outNodeId < 0) continue;
+        if (static_cast<int>(innovIds->size()) < record.inNodeId + 1) {
+            innovIds->resize(static_cast<std::size_t>(record.inNodeId) + 1);
+        }
+        auto& row = (*innovIds)[static_cast<std::size_t>(record.inNodeId)];
+        if (static_cast<int>(row.size()) < record.outNodeId + 1) {
+            row.resize(static_cast<std::size_t>(record.outNodeId) + 1, -1);
+        }
+        row[static_cast<std::size_t>(record.outNodeId)] = record.innovId;
+        *lastInnovId = std::max(*lastInnovId, record.innovId);
+    }
+}
+
+MappedGenomeArchive::~MappedGenomeArchive() {
+    close();
+}
+
+bool MappedGenomeArchive::open(const std::string& path) {
+    close();
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* address = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapped = static_cast<const std::byte*>(address);
+    mappedSize = static_cast<std::size_t>(info.st_size);
+    archive = GenomeArchiveView::open(mapped, mappedSize);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    fallback.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(fallback.data()), static_cast<std::streamsize>(fallback.size()));
+    archive = GenomeArchiveView::open(fallback.data(), fallback.size());
+#endif
+    if (!archive) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedGenomeArchive::close() {
+    archive.reset();
+#if !defined(_WIN32)
+    if (mapped) {
+        ::munmap(const_cast<std::byte*>(mapped), mappedSize);
+    }
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+    fallback.clear();
+}
+
+std::vector<std::byte> encodeGenomeArchive(const std::vector<const Genome*>& genomes, const std::vector<std::vector<int>>* innovIds) {
+    std::vector<const Genome*> present;
+    present.reserve(genomes.size());
+    for (const Genome* genome : genomes) {
+        if (genome) present.push_back(genome);
+    }
+    const std::vector<InnovationRecord> innovations = collectInnovations(innovIds);
+
+    const std::size_t innovationOffset = alignSection(sizeof(GenomeFileHeader));
+    const std::size_t indexOffset = alignSection(innovationOffset + innovations.size() * sizeof(InnovationRecord));
+    std::size_t fileSize = alignSection(indexOffset + present.size() * sizeof(std::uint64_t));
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(present.size());
+    for (const Genome* genome : present) {
+        offsets.push_back(fileSize);
+        fileSize += genomeRecordSize(genome->nodes.size(), genome->connections.size());
+    }
+
+    std::vector<std::byte> buffer(fileSize);
+    GenomeFileHeader header{};
+    std::memcpy(header.magic, kArchiveMagic, sizeof(kArchiveMagic));
+    header.version = kGenomeArchiveVersion;
+    header.headerSize = sizeof(GenomeFileHeader);
+    header.genomeCount = static_cast<std::uint32_t>(present.size());
+    header.innovationCount = static_cast<std::uint32_t>(innovations.size());
+    header.innovationOffset = innovationOffset;
+    header.genomeIndexOffset = indexOffset;
+    header.fileSize = fileSize;
+    storeAt(buffer, 0, header);
+    if (!innovations.empty()) {
+        std::memcpy(buffer.data() + innovationOffset, innovations.data(), innovations.size() * sizeof(InnovationRecord));
+    }
+    if (!offsets.empty()) {
+        std::memcpy(buffer.data() + indexOffset, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+    }
+
+    for (std::size_t g = 0; g < present.size(); ++g) {
+        const Genome& genome = *present[g];
+        std::size_t offset = static_cast<std::size_t>(offsets[g]);
+
+        GenomeRecordHeader record{};
+        record.nbInput = genome.nbInput;
+        record.nbOutput = genome.nbOutput;
+        record.weightExtremumInit = genome.getWeightExtremumInit();
+        record.fitness = genome.fitness;
+        record.speciesId = genome.speciesId;
+        record.nodeCount = static_cast<std::uint32_t>(genome.nodes.size());
+        record.connectionCount = static_cast<std::uint32_t>(genome.connections.size());
+        storeAt(buffer, offset, record);
+        offset += sizeof(GenomeRecordHeader);
+
+        for (const Node& node : genome.nodes) {
+            NodeRecord nodeRecord{};
+            nodeRecord.id = node.id;
+            nodeRecord.layer = node.layer;
+            nodeRecord.enabled = node.enabled ? 1 : 0;
+            storeAt(buffer, offset, nodeRecord);
+            offset += sizeof(NodeRecord);
+        }
+        offset = alignSection(offset);
+
+        for (const Connection& conn : genome.connections) {
+            ConnectionRecord connRecord{};
+            connRecord.innovId = conn.innovId;
+            connRecord.inNodeId = conn.inNodeId;
+            connRecord.outNodeId = conn.outNodeId;
+            connRecord.weight = conn.weight;
+            connRecord.enabled = conn.enabled ? 1 : 0;
+            storeAt(buffer, offset, connRecord);
+            offset += sizeof(ConnectionRecord);
+        }
+    }
+    return buffer;
+}
+
+bool writeGenomeArchive(const std::string& path, const std::vector<const Genome*>& genomes, const std::vector<std::vector<int>>* innovIds) {
+    const std::vector<std::byte> buffer = encodeGenomeArchive(genomes, innovIds);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(out);
+}
+
+std::vector<Genome> readGenomeArchive(const std::string& path, std::vector<std::vector<int>>* innovIds, int* lastInnovId) {
+    MappedGenomeArchive archive;
+    if (!archive.open(path)) {
+        return {};
+    }
+    if (innovIds && lastInnovId) {
+        archive.view()->seedInnovations(innovIds, lastInnovId);
+    }
+    return archive.view()->toGenomes();
+}
+
+} // namespace neat
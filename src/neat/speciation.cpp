@@ -0,0 +1,216 @@
+#include <neat/speciation.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace neat {
+
+float compatibilityDistance(const Genome& a, const Genome& b, const CompatibilityCoefficients& coefficients) {
+    const GeneAlignment alignment = Genome::alignGenes(a, b);
+    const std::size_t largest = std::max(a.connections.size(), b.connections.size());
+    const float normalizer = largest < 20 ? 1.0f : static_cast<float>(largest);
+    const float meanWeightDifference = alignment.matching > 0 ? alignment.weightDifferenceSum / static_cast<float>(alignment.matching) : 0.0f;
+    return coefficients.excess * static_cast<float>(alignment.excess) / normalizer +
+           coefficients.disjoint * static_cast<float>(alignment.disjoint) / normalizer +
+           coefficients.weight * meanWeightDifference;
+}
+
+SpeciationService::SpeciationService() : worker([this] { workerLoop(); }) {}
+
+SpeciationService::~SpeciationService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SpeciationService::setCoefficients(const CompatibilityCoefficients& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    coefficients = value;
+    coefficientsChanged = true;
+}
+
+CompatibilityCoefficients SpeciationService::getCoefficients() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return coefficients;
+}
+
+void SpeciationService::submit(std::uint64_t token, const Genome& genome) {
+    Genome copy = genome;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto pending = pendingAssign.find(token);
+        if (pending != pendingAssign.end()) {
+            // Not picked up yet: the newer genome supersedes the queued one.
+            jobs[pending->second - jobs.front().sequence].genome = std::move(copy);
+            return;
+        }
+        Job job;
+        job.kind = Job::Kind::Assign;
+        job.token = token;
+        job.genome.emplace(std::move(copy));
+        pushJobLocked(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void SpeciationService::release(std::uint64_t token) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // A queued Assign stays ahead of the release, but a later submit must queue behind it.
+        pendingAssign.erase(token);
+        Job job;
+        job.kind = Job::Kind::Release;
+        job.token = token;
+        pushJobLocked(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void SpeciationService::pushJobLocked(Job job) {
+    job.sequence = nextSequence++;
+    if (job.kind == Job::Kind::Assign) {
+        pendingAssign[job.token] = job.sequence;
+    }
+    jobs.push_back(std::move(job));
+    stats.pending = jobs.size();
+}
+
+std::vector<SpeciationService::Assignment> SpeciationService::drainAssignments() {
+    std::vector<Assignment> out;
+    std::lock_guard<std::mutex> lock(mutex);
+    out.swap(ready);
+    return out;
+}
+
+SpeciationService::Stats SpeciationService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void SpeciationService::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping) {
+            return;
+        }
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        if (job.kind == Job::Kind::Assign) {
+            auto pending = pendingAssign.find(job.token);
+            if (pending != pendingAssign.end() && pending->second == job.sequence) {
+                pendingAssign.erase(pending);
+            }
+        }
+        if (coefficientsChanged) {
+            workerCoefficients = coefficients;
+            coefficientsChanged = false;
+            cache.fill(CacheEntry{});
+        }
+        lock.unlock();
+
+        processJob(job);
+
+        lock.lock();
+        if (job.kind == Job::Kind::Assign) {
+            ready.push_back({job.token, memberSpecies[job.token]});
+        }
+        refreshStatsLocked();
+    }
+}
+
+void SpeciationService::processJob(Job& job) {
+    switch (job.kind) {
+    case Job::Kind::Assign: {
+        auto previous = memberSpecies.find(job.token);
+        if (previous != memberSpecies.end()) {
+            // Re-submission (e.g. a reseeded creature): leave the old species first.
+            Job leave;
+            leave.kind = Job::Kind::Release;
+            leave.token = job.token;
+            processJob(leave);
+        }
+        const int speciesId = assignSpecies(*job.genome);
+        memberSpecies[job.token] = speciesId;
+        ++assignedTotal;
+        break;
+    }
+    case Job::Kind::Release: {
+        auto it = memberSpecies.find(job.token);
+        if (it == memberSpecies.end()) {
+            return;
+        }
+        const int speciesId = it->second;
+        memberSpecies.erase(it);
+        auto speciesIt = std::find_if(species.begin(), species.end(), [&](const Species& s) { return s.id == speciesId; });
+        if (speciesIt != species.end() && --speciesIt->members <= 0) {
+            species.erase(speciesIt);
+        }
+        break;
+    }
+    }
+}
+
+int SpeciationService::assignSpecies(const Genome& genome) {
+    const std::uint64_t genomeHash = hashGenome(genome);
+    for (auto& candidate : species) {
+        if (cachedDistance(genome, genomeHash, candidate) < workerCoefficients.threshold) {
+            ++candidate.members;
+            return candidate.id;
+        }
+    }
+    Species founded{nextSpeciesId++, 1, genome};
+    species.push_back(std::move(founded));
+    return species.back().id;
+}
+
+float SpeciationService::cachedDistance(const Genome& genome, std::uint64_t genomeHash, const Species& candidate) {
+    CacheEntry& entry = cache[(genomeHash ^ static_cast<std::uint64_t>(candidate.id) * 0x9E3779B97F4A7C15ull) % kCacheSize];
+    if (entry.speciesId == candidate.id && entry.genomeHash == genomeHash) {
+        ++cacheHits;
+        return entry.distance;
+    }
+    ++distanceEvaluations;
+    const float distance = compatibilityDistance(genome, candidate.representative, workerCoefficients);
+    entry = {genomeHash, candidate.id, distance};
+    return distance;
+}
+
+void SpeciationService::refreshStatsLocked() {
+    stats.pending = jobs.size();
+    stats.assigned_total = assignedTotal;
+    stats.distance_evaluations = distanceEvaluations;
+    stats.cache_hits = cacheHits;
+    stats.species.clear();
+    stats.species.reserve(species.size());
+    for (const auto& s : species) {
+        stats.species.push_back({s.id, s.members});
+    }
+    std::sort(stats.species.begin(), stats.species.end(), [](const SpeciesInfo& lhs, const SpeciesInfo& rhs) {
+        return lhs.members > rhs.members;
+    });
+}
+
+std::uint64_t SpeciationService::hashGenome(const Genome& genome) {
+    // FNV-1a over the connection genes, which is all the distance looks at.
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](std::uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    for (const auto& conn : genome.connections) {
+        std::uint32_t weightBits = 0;
+        std::memcpy(&weightBits, &conn.weight, sizeof(weightBits));
+        mix(static_cast<std::uint32_t>(conn.innovId));
+        mix(weightBits);
+        mix(conn.enabled ? 1u : 0u);
+    }
+    return hash;
+}
+
+} // namespace neat
@@ -5,6 +5,7 @@
 #include "creatures/creature_circle.hpp"
 #include <unordered_map>
 #include <algorithm>
+#include <cstdio>
 
 namespace {
 struct CursorSettings {
@@ -23,6 +24,14 @@ struct RegionSettings {
 
 struct BrainSettings {
     float updates_per_sim_second = 0.0f;
+    bool eval_cache_enabled = true;
+    float eval_cache_epsilon = 0.0f;
+    float cost_per_connection = 0.0f;
+    float cost_per_node = 0.0f;
+    float flops_budget = 0.0f;
+    int sensor_mode = static_cast<int>(CreatureCircle::SensorMode::Exact);
+    float vision_radius = 0.0f;
+    int vision_summary = static_cast<int>(CreatureCircle::VisionSummary::Weighted);
 };
 
 struct CreatureSettings {
@@ -40,6 +49,8 @@ struct MovementSettings {
     float angular_damping = 0.0f;
     float boost_particle_impulse_fraction = 0.2f;
     float boost_particle_linear_damping = 0.5f;
+    int physics_quality = static_cast<int>(Game::PhysicsQuality::AdaptiveSubsteps);
+    int max_physics_substeps = 4;
 };
 
 struct DeathSettings {
@@ -66,6 +77,9 @@ struct MutationSettings {
     float disable_connection_thresh = 0.0f;
     int max_iterations_find_node_thresh = 0;
     int mutation_rounds = 0;
+    float mating_probability = 0.0f;
+    bool speciation_enabled = true;
+    float species_compat_threshold = 0.0f;
     float init_add_node_thresh = 0.0f;
     float init_add_connection_thresh = 0.0f;
     int init_mutation_rounds = 0;
@@ -83,6 +97,7 @@ struct SpawningSettings {
     float sprinkle_rate_eatable = 50.0f;
     float sprinkle_rate_toxic = 0.0f;
     float sprinkle_rate_division = 0.0f;
+    bool lightweight_pellets = false;
 };
 
 struct CleanupSettings {
@@ -348,6 +363,14 @@ void initialize_state(UiState& state, UiFacade& game) {
     state.time_scale.requested = g.get_time_scale();
     state.time_scale.display = state.time_scale.requested;
     state.brain.updates_per_sim_second = g.get_brain_updates_per_sim_second();
+    state.brain.eval_cache_enabled = g.get_brain_eval_cache_enabled();
+    state.brain.eval_cache_epsilon = g.get_brain_eval_cache_epsilon();
+    state.brain.cost_per_connection = g.get_brain_cost_per_connection();
+    state.brain.cost_per_node = g.get_brain_cost_per_node();
+    state.brain.flops_budget = g.get_brain_flops_budget();
+    state.brain.sensor_mode = static_cast<int>(g.get_sensor_mode());
+    state.brain.vision_radius = g.get_vision_radius();
+    state.brain.vision_summary = static_cast<int>(g.get_vision_summary());
     state.creature.minimum_area = g.get_minimum_area();
     state.creature.average_area = g.get_average_creature_area();
     state.creature.boost_area = g.get_boost_area();
@@ -365,6 +388,9 @@ void initialize_state(UiState& state, UiFacade& game) {
     state.mutation.init_add_connection_thresh = g.get_init_add_connection_thresh();
     state.mutation.init_mutation_rounds = g.get_init_mutation_rounds();
     state.mutation.mutation_rounds = g.get_mutation_rounds();
+    state.mutation.mating_probability = g.get_mating_probability();
+    state.mutation.speciation_enabled = g.get_speciation_enabled();
+    state.mutation.species_compat_threshold = g.get_species_compat_threshold();
     state.mutation.weight_thresh = g.get_mutate_weight_thresh();
     state.mutation.weight_full_change_thresh = g.get_mutate_weight_full_change_thresh();
     state.mutation.weight_factor = g.get_mutate_weight_factor();
@@ -382,6 +408,8 @@ void initialize_state(UiState& state, UiFacade& game) {
     state.movement.angular_impulse = g.get_angular_impulse_magnitude();
     state.movement.linear_damping = g.get_linear_damping();
     state.movement.angular_damping = g.get_angular_damping();
+    state.movement.physics_quality = static_cast<int>(g.get_physics_quality());
+    state.movement.max_physics_substeps = g.get_max_physics_substeps();
     state.spawning.minimum_creatures = g.get_minimum_creature_count();
     state.spawning.sprinkle_rate_eatable = g.get_sprinkle_rate_eatable();
     state.spawning.sprinkle_rate_toxic = g.get_sprinkle_rate_toxic();
@@ -396,6 +424,7 @@ void initialize_state(UiState& state, UiFacade& game) {
     state.spawning.food_density = g.get_food_pellet_density();
     state.spawning.toxic_density = g.get_toxic_pellet_density();
     state.spawning.division_density = g.get_division_pellet_density();
+    state.spawning.lightweight_pellets = g.get_lightweight_pellets();
     state.follow_selected = sel.get_follow_selected();
     state.selection_mode = selection_mode_to_index(sel.get_selection_mode());
     state.initialized = true;
@@ -508,6 +537,87 @@ void render_overview_content(UiFacade& game, UiState& state) {
         show_hover_text("Longest survival among creatures since spawn and since their last division.");
         ImGui::Text("Max generation: %d", g.get_max_generation());
         show_hover_text("Highest division count reached by any creature so far.");
+        const auto species = g.get_speciation_stats();
+        if (species.species.empty()) {
+            ImGui::Text("Species alive: 0");
+        } else {
+            ImGui::Text("Species alive: %zu  (largest #%d with %d members)",
+                        species.species.size(),
+                        species.species.front().id,
+                        species.species.front().members);
+        }
+        show_hover_text("Creatures grouped by NEAT compatibility distance to each species' founding genome.");
+        ImGui::Text("Color sensors: %d", g.get_color_sensor_count());
+        show_hover_text("Sensor sectors per creature, fixed when the dish is created (start with --sensors 4|8|16|32).");
+    }
+
+    if (ImGui::CollapsingHeader("Profiler")) {
+        const auto& stats = g.get_profiler_stats();
+        const auto hit_rate = [](std::size_t hits, std::size_t total) {
+            return total > 0 ? 100.0f * static_cast<float>(hits) / static_cast<float>(total) : 0.0f;
+        };
+        ImGui::Text("Brain cache hits (last tick): %zu / %zu  (%.1f%%)",
+                    stats.brain_cache_hits_last_tick,
+                    stats.brain_evaluations_last_tick,
+                    hit_rate(stats.brain_cache_hits_last_tick, stats.brain_evaluations_last_tick));
+        show_hover_text("Brain ticks that reused the previous network outputs because inputs did not change.");
+        ImGui::Text("Brain cache hits (total): %zu / %zu  (%.1f%%)",
+                    stats.brain_cache_hits_total,
+                    stats.brain_evaluations_total,
+                    hit_rate(stats.brain_cache_hits_total, stats.brain_evaluations_total));
+        show_hover_text("Cumulative cache hit rate since the simulation started.");
+        ImGui::Text("Matings since start: %zu", stats.matings_total);
+        show_hover_text("Divisions whose child brain came from crossover with a touching creature.");
+        ImGui::Text("Contact pairs (last tick): %zu", stats.contact_pairs_last_tick);
+        show_hover_text("Touching pairs whose geometry was computed once and shared by eating and sensing.");
+        ImGui::Text("Vision candidates (last brain tick): %zu", stats.vision_candidates_last_tick);
+        show_hover_text("Circles returned by the vision range queries, summed over all creatures.");
+        ImGui::Text("Physics step: %.2f ms (sensors %.2f ms)", stats.physics_step_ms_last_tick, stats.physics_sensors_ms_last_tick);
+        show_hover_text("Box2D's own timing of the last b2World_Step and of its sensor overlap pass.");
+        ImGui::Text("Step: %.4f s x %d substeps (fastest body %.2f radii/s)",
+                    stats.physics_dt_last_tick,
+                    stats.physics_substeps_last_tick,
+                    stats.fastest_speed_over_radius);
+        show_hover_text("Step size and substep count chosen by the physics quality setting, and the fastest body after this tick's impulses, which the next step is chosen from. Boost particles are left out.");
+        ImGui::Text("Bodies: %zu awake, %zu sleeping", stats.awake_bodies, stats.sleeping_bodies);
+        show_hover_text("Sleeping bodies skip the Box2D solver. Pellets fall asleep once settled and wake when a creature touches them; creatures and boost particles never sleep.");
+        ImGui::Text("Moved bodies (last tick): %zu", stats.moved_bodies_last_tick);
+        show_hover_text("Body move events copied into the transform cache. Position, angle and velocity reads come from that cache instead of calling into Box2D.");
+        ImGui::Text("Shape resizes (last tick): %zu of %zu requests", stats.shape_resizes_last_tick, stats.resize_requests_last_tick);
+        show_hover_text("Radius changes are queued and applied once per body just before the physics step, so a creature that eats several pellets and boosts in one tick updates its shape once.");
+        ImGui::Text("Impulse commands (last tick): %zu", stats.impulse_commands_last_tick);
+        show_hover_text("Boost and division impulses recorded while creatures act and applied to Box2D in one batched pass.");
+        ImGui::Text("Lightweight pellets: %zu", g.get_stored_pellet_count());
+        show_hover_text("Pellets held in the PelletStore, outside Box2D.");
+        ImGui::Text("Sensor events (last tick): %zu, overlapping pairs: %zu", stats.sensor_events_last_tick, stats.contact_graph_pairs);
+        show_hover_text("Begin/end touch events reported by Box2D and the overlaps they add up to. Pellets and boost particles only overlap creatures; pairs among them are filtered out before the broadphase test.");
+        const auto speciation = g.get_speciation_stats();
+        const std::size_t distance_lookups = speciation.distance_evaluations + speciation.cache_hits;
+        ImGui::Text("Speciation: %zu queued, %zu assigned, distance cache %.1f%%",
+                    speciation.pending,
+                    speciation.assigned_total,
+                    hit_rate(speciation.cache_hits, distance_lookups));
+        show_hover_text("Background species assignment; the cache skips distances already computed for identical genomes.");
+
+        ImGui::SeparatorText("Brain compute");
+        ImGui::Text("FLOPs per brain tick - executed: %zu  nominal: %zu",
+                    stats.brain_flops_executed_last_tick,
+                    stats.brain_flops_nominal_last_tick);
+        show_hover_text("Estimated network FLOPs summed over all creatures; executed excludes cache hits.");
+        ImGui::Text("Enabled connections: %zu  hidden nodes: %zu",
+                    stats.brain_connections_last_tick,
+                    stats.brain_hidden_nodes_last_tick);
+        show_hover_text("Population-wide brain size at the last brain tick.");
+        ImGui::Text("Brain metabolic drain: %.4f m^2 per tick", stats.brain_metabolic_area_last_tick);
+        show_hover_text("Total area creatures paid for their brains at the last brain tick.");
+        const float budget = g.get_brain_flops_budget();
+        if (budget > 0.0f) {
+            const float used = static_cast<float>(stats.brain_flops_nominal_last_tick) / budget;
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%.0f%% of budget", used * 100.0f);
+            ImGui::ProgressBar(std::min(used, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+            show_hover_text("Nominal brain FLOPs per tick relative to the configured compute budget.");
+        }
     }
 
     if (ImGui::CollapsingHeader("Follow targets & selection", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -541,6 +651,11 @@ void render_overview_content(UiFacade& game, UiState& state) {
             ImGui::Text("Selected creature: generation %d", selected_gen);
             ImGui::Text("Nodes: %zu", selected_brain->nodes.size());
             ImGui::Text("Connections: %zu", selected_brain->connections.size());
+            if (selected_brain->speciesId >= 0) {
+                ImGui::Text("Species: #%d", selected_brain->speciesId);
+            } else {
+                ImGui::Text("Species: pending");
+            }
             if (const auto* creature = sel.get_selected_creature()) {
                 ImGui::Text("Age: %.2fs", g.get_sim_time() - creature->get_creation_time());
                 ImGui::Text("Area: %.3f  Radius: %.3f", creature->getArea(), creature->getRadius());
@@ -574,6 +689,74 @@ void render_simulation_tab(UiFacade& game, UiState& state) {
             g.set_brain_updates_per_sim_second(state.brain.updates_per_sim_second);
         }
         show_hover_text("How many times creature AI brains tick per simulated second.");
+        if (ImGui::Checkbox("Brain evaluation cache", &state.brain.eval_cache_enabled)) {
+            g.set_brain_eval_cache_enabled(state.brain.eval_cache_enabled);
+        }
+        show_hover_text("Skip running a brain whose inputs have not changed since its last evaluation.");
+        ImGui::BeginDisabled(!state.brain.eval_cache_enabled);
+        if (ImGui::SliderFloat("Cache input epsilon", &state.brain.eval_cache_epsilon, 0.0f, 0.01f, "%.5f", ImGuiSliderFlags_Logarithmic)) {
+            g.set_brain_eval_cache_epsilon(state.brain.eval_cache_epsilon);
+        }
+        show_hover_text("Largest per-input change still treated as unchanged; 0 requires exact matches.");
+        ImGui::EndDisabled();
+
+        ImGui::SeparatorText("Color sensor geometry");
+        if (ImGui::RadioButton("Exact", state.brain.sensor_mode == static_cast<int>(CreatureCircle::SensorMode::Exact))) {
+            state.brain.sensor_mode = static_cast<int>(CreatureCircle::SensorMode::Exact);
+            g.set_sensor_mode(CreatureCircle::SensorMode::Exact);
+        }
+        show_hover_text("Closed-form overlap of every neighbor with every sensor sector.");
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Lookup table", state.brain.sensor_mode == static_cast<int>(CreatureCircle::SensorMode::LookupTable))) {
+            state.brain.sensor_mode = static_cast<int>(CreatureCircle::SensorMode::LookupTable);
+            g.set_sensor_mode(CreatureCircle::SensorMode::LookupTable);
+        }
+        show_hover_text("Interpolated overlap table: mean error ~1e-4 of a neighbor's area per sector, worst case\n"
+                        "0.05 (8+ sensors) for tiny distant neighbors right on a sector boundary.");
+
+        ImGui::SeparatorText("Vision");
+        if (ImGui::SliderFloat("Vision radius (m)", &state.brain.vision_radius, 0.0f, 20.0f, "%.2f")) {
+            g.set_vision_radius(state.brain.vision_radius);
+        }
+        show_hover_text("How far past its body a creature sees, queried from the spatial grid; 0 senses touching circles only.");
+        ImGui::BeginDisabled(state.brain.vision_radius <= 0.0f);
+        if (ImGui::RadioButton("Weighted", state.brain.vision_summary == static_cast<int>(CreatureCircle::VisionSummary::Weighted))) {
+            state.brain.vision_summary = static_cast<int>(CreatureCircle::VisionSummary::Weighted);
+            g.set_vision_summary(CreatureCircle::VisionSummary::Weighted);
+        }
+        show_hover_text("Each sector blends every visible circle by its coverage, fading with distance.");
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Nearest", state.brain.vision_summary == static_cast<int>(CreatureCircle::VisionSummary::Nearest))) {
+            state.brain.vision_summary = static_cast<int>(CreatureCircle::VisionSummary::Nearest);
+            g.set_vision_summary(CreatureCircle::VisionSummary::Nearest);
+        }
+        show_hover_text("Each sector reports only the closest circle it sees, fading with distance.");
+        ImGui::EndDisabled();
+
+        ImGui::SeparatorText("Brain metabolic cost");
+        if (ImGui::SliderFloat("Cost per connection (m^2)", &state.brain.cost_per_connection, 0.0f, 0.01f, "%.5f", ImGuiSliderFlags_Logarithmic)) {
+            g.set_brain_cost_per_connection(state.brain.cost_per_connection);
+        }
+        show_hover_text("Area drained each brain tick for every enabled connection; 0 disables the cost.");
+        if (ImGui::SliderFloat("Cost per hidden node (m^2)", &state.brain.cost_per_node, 0.0f, 0.01f, "%.5f", ImGuiSliderFlags_Logarithmic)) {
+            g.set_brain_cost_per_node(state.brain.cost_per_node);
+        }
+        show_hover_text("Area drained each brain tick for every enabled hidden node; 0 disables the cost.");
+        if (ImGui::SliderFloat("Brain FLOPs budget per tick", &state.brain.flops_budget, 0.0f, 1.0e7f, "%.0f", ImGuiSliderFlags_Logarithmic)) {
+            g.set_brain_flops_budget(state.brain.flops_budget);
+        }
+        show_hover_text("Population compute budget shown in the profiler; 0 hides the budget bar.");
+
+        ImGui::SeparatorText("Brain corpus");
+        if (ImGui::Button("Export brain corpus")) {
+            game.population_mgr().export_brain_corpus("brain_corpus.txt");
+        }
+        show_hover_text("Writes every living creature's genome to brain_corpus.txt for the NEAT microbenchmarks.");
+        ImGui::SameLine();
+        if (ImGui::Button("Save brain archive")) {
+            game.population_mgr().export_brain_archive("brain_archive.neat");
+        }
+        show_hover_text("Writes every living creature's genome and the innovation table to brain_archive.neat (binary).");
     }
 
     if (ImGui::CollapsingHeader("Sizes & costs", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -619,6 +802,31 @@ void render_simulation_tab(UiFacade& game, UiState& state) {
         }
         show_hover_text("Linear damping applied to boost particles only (broader range).");
 
+        ImGui::SeparatorText("Physics quality");
+        if (ImGui::RadioButton("Fixed", state.movement.physics_quality == static_cast<int>(Game::PhysicsQuality::Fixed))) {
+            state.movement.physics_quality = static_cast<int>(Game::PhysicsQuality::Fixed);
+            g.set_physics_quality(Game::PhysicsQuality::Fixed);
+        }
+        show_hover_text("Always 1/60 s steps with 4 substeps.");
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Adaptive substeps", state.movement.physics_quality == static_cast<int>(Game::PhysicsQuality::AdaptiveSubsteps))) {
+            state.movement.physics_quality = static_cast<int>(Game::PhysicsQuality::AdaptiveSubsteps);
+            g.set_physics_quality(Game::PhysicsQuality::AdaptiveSubsteps);
+        }
+        show_hover_text("1/60 s steps; just enough substeps that no body moves more than a quarter of its radius per substep.");
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Adaptive step", state.movement.physics_quality == static_cast<int>(Game::PhysicsQuality::AdaptiveStep))) {
+            state.movement.physics_quality = static_cast<int>(Game::PhysicsQuality::AdaptiveStep);
+            g.set_physics_quality(Game::PhysicsQuality::AdaptiveStep);
+        }
+        show_hover_text("Also stretches the step up to 1/30 s while everything is slow, and shortens it down to 1/120 s when something is fast.");
+        ImGui::BeginDisabled(state.movement.physics_quality == static_cast<int>(Game::PhysicsQuality::Fixed));
+        if (ImGui::SliderInt("Max substeps", &state.movement.max_physics_substeps, 1, 8)) {
+            g.set_max_physics_substeps(state.movement.max_physics_substeps);
+        }
+        show_hover_text("Upper bound on the substeps the adaptive modes may pick.");
+        ImGui::EndDisabled();
+
         if (movement_changed) {
             sim.set_circle_density(state.movement.circle_density);
             sim.set_linear_impulse_magnitude(state.movement.linear_impulse);
@@ -706,12 +914,25 @@ void render_mutation_tab(UiFacade& game, UiState& state) {
         show_hover_text("Probability passed to NEAT mutate for adding a connection during division.");
         division_mutate_changed |= ImGui::SliderInt("Mutation rounds", &state.mutation.mutation_rounds, 0, 50);
         show_hover_text("How many times to roll the mutation probabilities when a creature divides.");
+        division_mutate_changed |= ImGui::SliderFloat("Mating probability", &state.mutation.mating_probability, 0.0f, 1.0f, "%.2f");
+        show_hover_text("Chance a dividing creature crosses its brain with a touching creature's; the larger one supplies the topology.");
         if (division_mutate_changed) {
             g.set_add_node_thresh(state.mutation.add_node_thresh);
             g.set_add_connection_thresh(state.mutation.add_connection_thresh);
             g.set_mutation_rounds(state.mutation.mutation_rounds);
+            g.set_mating_probability(state.mutation.mating_probability);
         }
 
+        ImGui::SeparatorText("Speciation");
+        if (ImGui::Checkbox("Track species", &state.mutation.speciation_enabled)) {
+            g.set_speciation_enabled(state.mutation.speciation_enabled);
+        }
+        show_hover_text("Assign every new creature brain to a species on a background thread.");
+        if (ImGui::SliderFloat("Compatibility threshold", &state.mutation.species_compat_threshold, 0.1f, 20.0f, "%.2f", ImGuiSliderFlags_Logarithmic)) {
+            g.set_species_compat_threshold(state.mutation.species_compat_threshold);
+        }
+        show_hover_text("Largest compatibility distance to a species representative that still joins that species.");
+
         ImGui::SeparatorText("Live mutation (matches NEAT mutate)");
         if (ImGui::Checkbox("Enable live mutation", &state.mutation.live_mutation_enabled)) {
             g.set_live_mutation_enabled(state.mutation.live_mutation_enabled);
@@ -761,6 +982,10 @@ void render_spawning_controls(UiFacade& game, UiState& state) {
         show_hover_text("Target area fraction for toxic pellets.");
         spawning_changed |= ImGui::SliderFloat("Division area density (m^2 per m^2)", &state.spawning.division_density, 0.0f, 0.02f, "%.4f", ImGuiSliderFlags_Logarithmic);
         show_hover_text("Target area fraction for division-triggering blue pellets.");
+        if (ImGui::Checkbox("Lightweight pellets", &state.spawning.lightweight_pellets)) {
+            g.set_lightweight_pellets(state.spawning.lightweight_pellets);
+        }
+        show_hover_text("New pellets skip Box2D and live in a static grid that creatures query directly. Pellets already in the dish keep their current form.");
         ImGui::SeparatorText("Quick presets");
         render_preset_buttons(game, state);
         if (spawning_changed) {
@@ -781,7 +1006,8 @@ void render_spawning_controls(UiFacade& game, UiState& state) {
 #ifndef NDEBUG
         ImGui::SeparatorText("Cleanup pellets (max targets)");
         bool pellet_limits_changed = false;
-        pellet_limits_changed |= ImGui::SliderInt("Max food pellets", &state.spawning.max_food_pellets, 0, 5000);
+        const int max_food_limit = state.spawning.lightweight_pellets ? 500000 : 5000;
+        pellet_limits_changed |= ImGui::SliderInt("Max food pellets", &state.spawning.max_food_pellets, 0, max_food_limit, "%d", ImGuiSliderFlags_Logarithmic);
         pellet_limits_changed |= ImGui::SliderInt("Max toxic pellets", &state.spawning.max_toxic_pellets, 0, 5000);
         pellet_limits_changed |= ImGui::SliderInt("Max division pellets", &state.spawning.max_division_pellets, 0, 5000);
         show_hover_text("System auto-adjusts cleanup rates to keep pellets near these targets.");